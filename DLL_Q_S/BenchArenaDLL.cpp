@@ -0,0 +1,168 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include "DLL.h"
+#include "HugePageArena.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+/** Sink for traversal results, so they are not optimized away. */
+static volatile uint64_t sink;
+
+/**
+ * Counter of data TLB load misses in this process, through
+ * perf_event_open; reads -1 where that is unavailable or not permitted.
+ */
+class TlbCounter {
+public:
+  TlbCounter() : fd(-1) {
+#ifdef __linux__
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  ~TlbCounter() {
+#ifdef __linux__
+    if (fd >= 0) {
+      close(fd);
+    }
+#endif
+  }
+
+  void start() {
+#ifdef __linux__
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  long long stop() {
+    long long count = -1;
+#ifdef __linux__
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+        count = -1;
+      }
+    }
+#endif
+    return count;
+  }
+
+private:
+  int fd;
+};
+
+/**
+ * Get the kB of anonymous memory this process has in huge pages, or -1
+ * if /proc does not say.
+ */
+long anonHugeKb() {
+  ifstream in("/proc/self/smaps_rollup");
+  string line;
+  while (getline(in, line)) {
+    if (line.compare(0, 14, "AnonHugePages:") == 0) {
+      return strtol(line.c_str() + 14, 0, 10);
+    }
+  }
+  return -1;
+}
+
+/**
+ * Build a list of n elements, then sort it by a random key so that
+ * traversal order no longer follows allocation order, and time
+ * traversals of it.
+ */
+template <class List>
+void run(const char *name, List &list, size_t n, unsigned reps) {
+  mt19937_64 gen(246);
+  for (size_t i = 0u; i < n; i++) {
+    list.addLast(gen());
+  }
+  list.sort();
+
+  TlbCounter tlb;
+  uint64_t sum = 0u;
+  tlb.start();
+  steady_clock::time_point t0 = steady_clock::now();
+  for (unsigned r = 0u; r < reps; r++) {
+    for (typename List::ConstIterator it = list.cbegin(); it != list.cend();
+         ++it) {
+      sum += *it;
+    }
+  }
+  double ns = duration<double, nano>(steady_clock::now() - t0).count();
+  long long misses = tlb.stop();
+  sink = sum;
+
+  cout << name << ns / (double(n) * reps) << "\t\t";
+  if (misses >= 0) {
+    cout << double(misses) / (double(n) * reps);
+  } else {
+    cout << "n/a";
+  }
+  cout << "\t\t" << anonHugeKb() / 1024 << endl;
+}
+
+/**
+ * Benchmark of traversing a large list whose nodes are scattered in
+ * memory, with nodes from the general-purpose allocator, from a
+ * HugePageArena with ordinary pages, and from one with transparent huge
+ * pages. Linux only for the TLB counts and huge page sizes.
+ *
+ * Usage: BenchArenaDLL [n] [reps]
+ */
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? strtoull(argv[1], 0, 10) : 16000000u;
+  unsigned reps = argc > 2 ? strtoul(argv[2], 0, 10) : 3u;
+
+  cout << n << " elements, visited in random memory order" << endl;
+  cout << "nodes from        ns/element\tdTLB misses/element\tMB in huge pages"
+       << endl;
+
+  {
+    DLL<uint64_t> list;
+    run("std::allocator    ", list, n, reps);
+  }
+  {
+    HugePageArena arena(HugePageArena::hugePageSize * 32u, false);
+    DLL<uint64_t, Checked, ArenaAllocator<uint64_t> > list(
+        (ArenaAllocator<uint64_t>(arena)));
+    run("arena, 4K pages   ", list, n, reps);
+  }
+  {
+    HugePageArena arena(HugePageArena::hugePageSize * 32u, true);
+    DLL<uint64_t, Checked, ArenaAllocator<uint64_t> > list(
+        (ArenaAllocator<uint64_t>(arena)));
+    run("arena, huge pages ", list, n, reps);
+    if (arena.hugePageRegions() == 0u) {
+      cout << "(huge pages were not available)" << endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
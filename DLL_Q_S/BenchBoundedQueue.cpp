@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "BoundedQueue.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Move n integers from producers to consumers through a BoundedQueue
+ * and return the sustained throughput in millions of elements per
+ * second. A batch size of 1 uses enqueue/dequeue, larger batch sizes
+ * use enqueueBatch/dequeueBatch.
+ */
+double throughput(unsigned producers, unsigned consumers, unsigned capacity,
+                  unsigned batch, unsigned n) {
+  BoundedQueue<int> q(capacity);
+  vector<thread> threads;
+  unsigned perProducer = n / producers;
+
+  steady_clock::time_point start = steady_clock::now();
+
+  for (unsigned p = 0u; p < producers; p++) {
+    threads.push_back(thread([&q, perProducer, batch]() {
+      vector<int> items(batch);
+      for (unsigned i = 0u; i < perProducer; i += batch) {
+        if (batch == 1u) {
+          q.enqueue(static_cast<int>(i));
+        } else {
+          for (unsigned j = 0u; j < batch; j++) {
+            items[j] = static_cast<int>(i + j);
+          }
+          q.enqueueBatch(items.data(), batch);
+        }
+      }
+    }));
+  }
+
+  vector<thread> consumerThreads;
+  for (unsigned c = 0u; c < consumers; c++) {
+    consumerThreads.push_back(thread([&q, batch]() {
+      vector<int> items(batch);
+      int a;
+      if (batch == 1u) {
+        while (q.dequeue(a)) {
+        }
+      } else {
+        while (q.dequeueBatch(items.data(), batch) > 0u) {
+        }
+      }
+    }));
+  }
+
+  for (size_t i = 0u; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  q.close();
+  for (size_t i = 0u; i < consumerThreads.size(); i++) {
+    consumerThreads[i].join();
+  }
+
+  double s = duration<double>(steady_clock::now() - start).count();
+  return perProducer * producers / s / 1e6;
+}
+
+/**
+ * Benchmark of BoundedQueue sustained throughput.
+ *
+ * Usage: BenchBoundedQueue [n]
+ */
+int main(int argc, char *argv[]) {
+  unsigned n = argc > 1 ? strtoul(argv[1], 0, 10) : 2000000u;
+  unsigned configs[][4] = {{1u, 1u, 64u, 1u},    {1u, 1u, 1024u, 1u},
+                           {1u, 1u, 1024u, 64u}, {2u, 2u, 1024u, 1u},
+                           {2u, 2u, 1024u, 64u}, {4u, 4u, 1024u, 64u}};
+
+  cout << n << " elements, " << thread::hardware_concurrency()
+       << " hardware threads" << endl;
+  cout << "producers consumers capacity batch  Melem/s" << endl;
+
+  for (size_t i = 0u; i < sizeof(configs) / sizeof(configs[0]); i++) {
+    unsigned *c = configs[i];
+    cout << c[0] << "         " << c[1] << "         " << c[2] << "\t  "
+         << c[3] << "\t " << throughput(c[0], c[1], c[2], c[3], n) << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "BoundedQueue.h"
+#include "Channel.h"
+#include "Scheduler.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Send 0 .. count - 1 down a channel, then close it.
+ */
+Task source(Channel<int> &out, int count) {
+  for (int i = 0; i < count; i++) {
+    co_await out.enqueue(i);
+  }
+  out.close();
+}
+
+/**
+ * Forward every element, adding one.
+ */
+Task stage(Channel<int> &in, Channel<int> &out) {
+  while (optional<int> a = co_await in.dequeue()) {
+    co_await out.enqueue(*a + 1);
+  }
+  out.close();
+}
+
+/**
+ * Consume everything.
+ */
+Task sink(Channel<int> &in, long &total) {
+  while (optional<int> a = co_await in.dequeue()) {
+    total += *a;
+  }
+}
+
+/**
+ * Run a pipeline of coroutine stages and return ns per hop, i.e., per
+ * element per stage.
+ */
+template <class S> double coroutinePipeline(S &scheduler, int stages,
+                                            int count) {
+  vector<Channel<int> *> channels;
+  for (int i = 0; i <= stages; i++) {
+    channels.push_back(new Channel<int>(scheduler, 1u));
+  }
+  long total = 0;
+
+  steady_clock::time_point start = steady_clock::now();
+  scheduler.spawn(source(*channels[0], count));
+  for (int i = 0; i < stages; i++) {
+    scheduler.spawn(stage(*channels[i], *channels[i + 1]));
+  }
+  scheduler.spawn(sink(*channels[stages], total));
+  scheduler.run();
+  double ns = duration<double, nano>(steady_clock::now() - start).count();
+
+  for (size_t i = 0u; i < channels.size(); i++) {
+    delete channels[i];
+  }
+  return ns / (static_cast<double>(stages + 1) * count);
+}
+
+/**
+ * The same pipeline with a thread per stage, blocking on BoundedQueues.
+ */
+double threadPipeline(int stages, int count) {
+  vector<BoundedQueue<int> *> queues;
+  for (int i = 0; i <= stages; i++) {
+    queues.push_back(new BoundedQueue<int>(1u));
+  }
+  vector<thread> threads;
+  long total = 0;
+
+  steady_clock::time_point start = steady_clock::now();
+  threads.push_back(thread([&]() {
+    for (int i = 0; i < count; i++) {
+      queues[0]->enqueue(i);
+    }
+    queues[0]->close();
+  }));
+  for (int s = 0; s < stages; s++) {
+    threads.push_back(thread([&, s]() {
+      int a;
+      while (queues[s]->dequeue(a)) {
+        queues[s + 1]->enqueue(a + 1);
+      }
+      queues[s + 1]->close();
+    }));
+  }
+  int a;
+  while (queues[stages]->dequeue(a)) {
+    total += a;
+  }
+  for (size_t i = 0u; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  double ns = duration<double, nano>(steady_clock::now() - start).count();
+
+  for (size_t i = 0u; i < queues.size(); i++) {
+    delete queues[i];
+  }
+  return ns / (static_cast<double>(stages + 1) * count);
+}
+
+/**
+ * Benchmark of the cost of passing an element between pipeline stages:
+ * coroutines on one thread, coroutines on a thread pool, and one thread
+ * per stage.
+ *
+ * Usage: BenchChannel [count]
+ */
+int main(int argc, char *argv[]) {
+  int count = argc > 1 ? atoi(argv[1]) : 20000;
+
+  cout << "ns per hop, " << count << " elements, capacity-1 channels"
+       << endl;
+  cout << "stages  coroutines  pool(4)  thread/stage" << endl;
+
+  int stageCounts[] = {1, 16, 64, 1000, 10000};
+  for (int stages : stageCounts) {
+    SingleThreadScheduler single;
+    ThreadPoolScheduler pool(4u);
+    int n = stages >= 1000 ? count / 20 : count;
+
+    cout << stages << "\t" << coroutinePipeline(single, stages, n) << "\t    "
+         << coroutinePipeline(pool, stages, n) << "\t";
+    if (stages <= 64) {
+      cout << threadPipeline(stages, n);
+    } else {
+      cout << "(skipped)";
+    }
+    cout << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "DLL.h"
+#include "Queue.h"
+#include "Stack.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Time the hot loops of one checking policy, in ns per operation.
+ */
+template <class Check>
+void run(const char *name, unsigned n, unsigned reps, double &sink) {
+  DLL<double, Check> list;
+  for (unsigned i = 0u; i < n; i++) {
+    list.addLast(i * 0.5);
+  }
+
+  // iterator traversal: operator* and operator++ per element
+  steady_clock::time_point t0 = steady_clock::now();
+  for (unsigned r = 0u; r < reps; r++) {
+    for (typename DLL<double, Check>::Iterator it = list.begin();
+         it != list.end(); ++it) {
+      sink += *it;
+    }
+  }
+  steady_clock::time_point t1 = steady_clock::now();
+
+  // RPN-style stack traffic: pop two, push one, with a peek
+  Stack<double, Check> stack;
+  stack.push(1.0);
+  for (unsigned i = 0u; i < n * reps; i++) {
+    stack.push(i * 0.25);
+    double rhs = stack.pop();
+    double lhs = stack.pop();
+    stack.push(lhs + rhs);
+    sink += stack.peek();
+  }
+  steady_clock::time_point t2 = steady_clock::now();
+
+  // queue traffic with a steady backlog
+  Queue<double, Check> queue;
+  for (unsigned i = 0u; i < 64u; i++) {
+    queue.enqueue(i);
+  }
+  for (unsigned i = 0u; i < n * reps; i++) {
+    queue.enqueue(i);
+    sink += queue.dequeue();
+  }
+  steady_clock::time_point t3 = steady_clock::now();
+
+  double ops = double(n) * reps;
+  cout << name << duration<double, nano>(t1 - t0).count() / ops << "\t\t"
+       << duration<double, nano>(t2 - t1).count() / ops << "\t\t"
+       << duration<double, nano>(t3 - t2).count() / ops << endl;
+}
+
+/**
+ * Benchmark of the checking policies on DLL iteration, Stack push / pop
+ * / peek and Queue enqueue / dequeue. DebugAssert is timed with its
+ * asserts enabled; compiled with -DNDEBUG it matches Unchecked. Checked
+ * runs again last to show how much of the gap is warm-up.
+ *
+ * Usage: BenchCheckPolicy [n] [reps]
+ */
+int main(int argc, char *argv[]) {
+  unsigned n = argc > 1 ? strtoul(argv[1], 0, 10) : 100000u;
+  unsigned reps = argc > 2 ? strtoul(argv[2], 0, 10) : 50u;
+  double sink = 0.0;
+
+  cout << n << " elements x " << reps << " reps; ns per operation" << endl;
+  cout << "policy       iterate\t\tstack\t\tqueue" << endl;
+
+  run<Checked>("Checked      ", n, reps, sink);
+  run<DebugAssert>("DebugAssert  ", n, reps, sink);
+  run<Unchecked>("Unchecked    ", n, reps, sink);
+  run<Checked>("Checked      ", n, reps, sink);
+
+  // keep the results live
+  if (sink == 1.0) {
+    cout << sink << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "DLL.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * The approach being replaced: free every node, then allocate every
+ * node again.
+ */
+template <class T> void clearAndCopy(DLL<T> &dst, const DLL<T> &src) {
+  dst.clear();
+  for (typename DLL<T>::ConstIterator it = src.begin(); it != src.end();
+       ++it) {
+    dst.addLast(*it);
+  }
+}
+
+/**
+ * Time reps assignments of src to dst, alternating with a second source
+ * of the given length so that every assignment does real work. Returns
+ * ns per element copied.
+ */
+template <class T>
+double timeAssign(const DLL<T> &a, const DLL<T> &b, unsigned reps,
+                  bool reuse) {
+  DLL<T> dst(a);
+
+  steady_clock::time_point t0 = steady_clock::now();
+  for (unsigned r = 0u; r < reps; r++) {
+    const DLL<T> &src = r % 2u == 0u ? b : a;
+    if (reuse) {
+      dst = src;
+    } else {
+      clearAndCopy(dst, src);
+    }
+  }
+  double ns = duration<double, nano>(steady_clock::now() - t0).count();
+
+  return ns / (double(reps) * (a.size() + b.size()) / 2.0);
+}
+
+/**
+ * Fill a list with n elements made by make(i).
+ */
+template <class T, class Make>
+DLL<T> makeList(unsigned n, Make make) {
+  DLL<T> list;
+  for (unsigned i = 0u; i < n; i++) {
+    list.addLast(make(i));
+  }
+  return list;
+}
+
+/**
+ * Benchmark of repeated DLL assignment between lists of equal and of
+ * slightly different lengths, reusing nodes against clearing and
+ * rebuilding, for int and string elements.
+ *
+ * Usage: BenchCopyDLL [total]
+ */
+int main(int argc, char *argv[]) {
+  unsigned total = argc > 1 ? strtoul(argv[1], 0, 10) : 20000000u;
+
+  cout << "ns per element copied" << endl;
+  cout << "elements  lengths  type    clear+copy  reuse" << endl;
+
+  for (unsigned n = 100u; n <= 1000000u; n *= 100u) {
+    unsigned reps = total / n;
+    const char *lengths[] = {"equal", "+10%"};
+
+    for (unsigned shape = 0u; shape < 2u; shape++) {
+      unsigned m = shape == 0u ? n : n + n / 10u;
+
+      DLL<int> ia = makeList<int>(n, [](unsigned i) { return int(i); });
+      DLL<int> ib = makeList<int>(m, [](unsigned i) { return int(i * 3u); });
+      double iOld = timeAssign(ia, ib, reps, false);
+      double iNew = timeAssign(ia, ib, reps, true);
+      cout << n << "\t  " << lengths[shape] << "\t   int     " << iOld
+           << "\t  " << iNew << endl;
+
+      // strings long enough to live on the heap, so reuse also saves
+      // their buffers
+      DLL<string> sa = makeList<string>(
+          n, [](unsigned i) { return string(32u, char('a' + i % 26u)); });
+      DLL<string> sb = makeList<string>(
+          m, [](unsigned i) { return string(32u, char('A' + i % 26u)); });
+      double sOld = timeAssign(sa, sb, reps / 4u + 1u, false);
+      double sNew = timeAssign(sa, sb, reps / 4u + 1u, true);
+      cout << n << "\t  " << lengths[shape] << "\t   string  " << sOld
+           << "\t  " << sNew << endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "DLL.h"
+#include "ParallelDLL.h"
+#include "ThreadPool.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Benchmark of the parallel DLL algorithms on a multi-million element
+ * list, for increasing pool sizes; the 0-thread row is a serial
+ * iterator loop for reference.
+ *
+ * Usage: BenchParallelDLL [n]
+ */
+int main(int argc, char *argv[]) {
+  unsigned n = argc > 1 ? strtoul(argv[1], 0, 10) : 4000000u;
+
+  DLL<double> list;
+  for (unsigned i = 0u; i < n; i++) {
+    list.addLast(i * 0.001);
+  }
+
+  cout << n << " elements, " << thread::hardware_concurrency()
+       << " hardware threads; times in ms" << endl;
+  cout << "threads  transform  reduce  countIf" << endl;
+
+  // serial baseline
+  steady_clock::time_point t0 = steady_clock::now();
+  for (DLL<double>::Iterator it = list.begin(); it != list.end(); ++it) {
+    *it = sqrt(*it + 1.0);
+  }
+  steady_clock::time_point t1 = steady_clock::now();
+  double sum = 0.0;
+  for (DLL<double>::Iterator it = list.begin(); it != list.end(); ++it) {
+    sum += *it;
+  }
+  steady_clock::time_point t2 = steady_clock::now();
+  unsigned count = 0u;
+  for (DLL<double>::Iterator it = list.begin(); it != list.end(); ++it) {
+    if (*it > 10.0) {
+      count++;
+    }
+  }
+  steady_clock::time_point t3 = steady_clock::now();
+  cout << "0        " << duration<double, milli>(t1 - t0).count() << "\t    "
+       << duration<double, milli>(t2 - t1).count() << "\t    "
+       << duration<double, milli>(t3 - t2).count() << endl;
+
+  unsigned threadCounts[] = {1u, 2u, 4u, 8u};
+  for (unsigned threads : threadCounts) {
+    ThreadPool pool(threads);
+
+    t0 = steady_clock::now();
+    parallelTransform(pool, list, [](double a) { return sqrt(a + 1.0); });
+    t1 = steady_clock::now();
+    sum += parallelReduce(pool, list, 0.0,
+                          [](double a, double b) { return a + b; });
+    t2 = steady_clock::now();
+    count += parallelCountIf(pool, list, [](double a) { return a > 10.0; });
+    t3 = steady_clock::now();
+
+    cout << threads << "        " << duration<double, milli>(t1 - t0).count()
+         << "\t    " << duration<double, milli>(t2 - t1).count() << "\t    "
+         << duration<double, milli>(t3 - t2).count() << endl;
+  }
+
+  // keep the results live
+  if (sum < 0.0 || count == 1u) {
+    cout << sum << count << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <vector>
+#include "DLL.h"
+#include "PriorityQueue.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/** Sink for results, so they are not optimized away. */
+static volatile long sink;
+
+/**
+ * Time n enqueues followed by n dequeues on a priority queue type.
+ */
+template <class PQ> double timeQueue(const vector<int> &keys) {
+  steady_clock::time_point start = steady_clock::now();
+  PQ pq;
+  long sum = 0;
+
+  for (size_t i = 0u; i < keys.size(); i++) {
+    pq.enqueue(keys[i]);
+  }
+  while (!pq.isEmpty()) {
+    sum += pq.dequeue();
+  }
+
+  sink = sum;
+  return duration<double, milli>(steady_clock::now() - start).count();
+}
+
+/**
+ * The DLL emulation we are replacing: enqueue with addLast, dequeue by
+ * scanning for the greatest element and removing it by index.
+ */
+double timeDLLScan(const vector<int> &keys) {
+  steady_clock::time_point start = steady_clock::now();
+  DLL<int> list;
+  long sum = 0;
+
+  for (size_t i = 0u; i < keys.size(); i++) {
+    list.addLast(keys[i]);
+  }
+  while (!list.isEmpty()) {
+    unsigned best = 0u, idx = 0u;
+    int bestValue = list.getFirst();
+    for (DLL<int>::Iterator it = list.begin(); it != list.end(); ++it, idx++) {
+      if (*it > bestValue) {
+        bestValue = *it;
+        best = idx;
+      }
+    }
+    sum += list.remove(best);
+  }
+
+  sink = sum;
+  return duration<double, milli>(steady_clock::now() - start).count();
+}
+
+/**
+ * Adapter giving std::priority_queue the Queue-style interface.
+ */
+struct StdPQ {
+  priority_queue<int> pq;
+  void enqueue(int a) { pq.push(a); }
+  int dequeue() {
+    int a = pq.top();
+    pq.pop();
+    return a;
+  }
+  bool isEmpty() const { return pq.empty(); }
+};
+
+/**
+ * Benchmark of PriorityQueue against the DLL linear-scan emulation and
+ * std::priority_queue.
+ *
+ * Usage: BenchPriorityQueue [n]
+ */
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? strtoul(argv[1], 0, 10) : 1000000u;
+
+  mt19937 gen(246);
+  vector<int> keys(n);
+  for (size_t i = 0u; i < n; i++) {
+    keys[i] = static_cast<int>(gen() >> 1);
+  }
+
+  cout << n << " enqueues then " << n << " dequeues (ms)" << endl;
+  cout << "PriorityQueue D=2:    " << timeQueue<PriorityQueue<int> >(keys)
+       << endl;
+  cout << "PriorityQueue D=4:    "
+       << timeQueue<PriorityQueue<int, less<int>, 4> >(keys) << endl;
+  cout << "PriorityQueue D=8:    "
+       << timeQueue<PriorityQueue<int, less<int>, 8> >(keys) << endl;
+  cout << "std::priority_queue:  " << timeQueue<StdPQ>(keys) << endl;
+
+  // the O(n^2) scan only gets a small prefix
+  vector<int> small(keys.begin(), keys.begin() + min<size_t>(n, 20000u));
+  cout << small.size() << " elements:" << endl;
+  cout << "DLL scan:             " << timeDLLScan(small) << endl;
+  cout << "PriorityQueue D=2:    " << timeQueue<PriorityQueue<int> >(small)
+       << endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "Queue.h"
+#include "Reclaimer.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Simulate a request thread: each request does a little queue work,
+ * and every dropEvery-th request also drops a large queue, built
+ * beforehand. Print the latency percentiles of the requests and of the
+ * drops.
+ */
+void run(const char *name, Reclaimer *pReclaimer, unsigned requests,
+         unsigned dropEvery, unsigned bigSize) {
+  vector<double> all, drops;
+  Queue<int> *pBig = 0;
+
+  for (unsigned r = 0u; r < requests; r++) {
+    bool drop = r % dropEvery == dropEvery - 1u;
+    if (drop) {
+      // building is setup, not part of the request
+      pBig = new Queue<int>;
+      pBig->setReclaimer(pReclaimer);
+      for (unsigned i = 0u; i < bigSize; i++) {
+        pBig->enqueue(int(i));
+      }
+    }
+
+    steady_clock::time_point t0 = steady_clock::now();
+    Queue<int> work;
+    for (int i = 0; i < 1000; i++) {
+      work.enqueue(i);
+    }
+    while (!work.isEmpty()) {
+      work.dequeue();
+    }
+    if (drop) {
+      delete pBig;
+      pBig = 0;
+    }
+    double us = duration<double, micro>(steady_clock::now() - t0).count();
+
+    all.push_back(us);
+    if (drop) {
+      drops.push_back(us);
+    }
+  }
+
+  if (pReclaimer != 0) {
+    pReclaimer->drain();
+  }
+
+  sort(all.begin(), all.end());
+  sort(drops.begin(), drops.end());
+  cout << name << all[all.size() / 2u] << "\t" << all[all.size() * 99u / 100u]
+       << "\t" << all.back() << "\t" << drops[drops.size() / 2u] << "\t\t"
+       << drops.back() << endl;
+}
+
+/**
+ * Benchmark of the latency a request thread sees when it destroys large
+ * queues, freeing their nodes itself or handing them to a Reclaimer.
+ *
+ * Usage: BenchReclaimer [bigSize] [requests]
+ */
+int main(int argc, char *argv[]) {
+  unsigned bigSize = argc > 1 ? strtoul(argv[1], 0, 10) : 5000000u;
+  unsigned requests = argc > 2 ? strtoul(argv[2], 0, 10) : 2000u;
+  unsigned dropEvery = 100u;
+
+  cout << requests << " requests, every " << dropEvery << "th drops a "
+       << bigSize << " element queue; latency in us" << endl;
+  cout << "freed by           p50\tp99\tmax\tdrop p50\tdrop max" << endl;
+
+  run("request thread     ", 0, requests, dropEvery, bigSize);
+
+  Reclaimer reclaimer;
+  run("Reclaimer          ", &reclaimer, requests, dropEvery, bigSize);
+  cout << "(" << reclaimer.freedInBackground() << " freed in background, "
+       << reclaimer.freedInline() << " inline)" << endl;
+
+  return EXIT_SUCCESS;
+}
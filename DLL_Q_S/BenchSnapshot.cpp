@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "PersistentQueue.h"
+#include "PersistentStack.h"
+#include "Queue.h"
+#include "Stack.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Time a backtracking loop: snapshot the stack, try a few operations,
+ * then restore the snapshot. Returns ns per snapshot / restore round.
+ */
+template <class S> double backtrack(S &stack, unsigned rounds, double &sink) {
+  steady_clock::time_point t0 = steady_clock::now();
+
+  for (unsigned r = 0u; r < rounds; r++) {
+    S saved(stack);
+    stack.push(r);
+    stack.push(stack.pop() + stack.pop());
+    sink += stack.peek();
+    stack = saved;
+  }
+
+  return duration<double, nano>(steady_clock::now() - t0).count() / rounds;
+}
+
+/**
+ * Time taking and dropping snapshots of a work queue that keeps
+ * moving. Returns ns per round of snapshot, enqueue and dequeue.
+ */
+template <class Q> double monitor(Q &queue, unsigned rounds, double &sink) {
+  steady_clock::time_point t0 = steady_clock::now();
+
+  for (unsigned r = 0u; r < rounds; r++) {
+    Q snapshot(queue);
+    queue.enqueue(r);
+    sink += queue.dequeue() + snapshot.size();
+  }
+
+  return duration<double, nano>(steady_clock::now() - t0).count() / rounds;
+}
+
+/**
+ * Benchmark of snapshotting a Stack, which deep-copies its list, against
+ * a PersistentStack, which shares it, and likewise for Queue and
+ * PersistentQueue, for increasing depths and lengths.
+ *
+ * Usage: BenchSnapshot [rounds]
+ */
+int main(int argc, char *argv[]) {
+  unsigned rounds = argc > 1 ? strtoul(argv[1], 0, 10) : 2000u;
+  double sink = 0.0;
+
+  cout << "backtracking rounds (snapshot, push, pop, restore); ns per round"
+       << endl;
+  cout << "depth     Stack        PersistentStack" << endl;
+
+  for (unsigned depth = 10u; depth <= 100000u; depth *= 10u) {
+    Stack<double> stack;
+    PersistentStack<double> persistent;
+    for (unsigned i = 0u; i < depth; i++) {
+      stack.push(i);
+      persistent.push(i);
+    }
+
+    // fewer rounds for the deep copies, which take milliseconds
+    unsigned n = rounds * 10u / depth + 10u;
+    double tStack = backtrack(stack, n, sink);
+    double tPersistent = backtrack(persistent, rounds * 100u, sink);
+
+    cout << depth << "\t  " << tStack << "\t " << tPersistent << endl;
+  }
+
+  cout << endl << "monitoring rounds (snapshot, enqueue, dequeue); "
+       << "ns per round" << endl;
+  cout << "length    Queue        PersistentQueue" << endl;
+
+  for (unsigned length = 10u; length <= 100000u; length *= 10u) {
+    Queue<double> queue;
+    PersistentQueue<double> persistent;
+    for (unsigned i = 0u; i < length; i++) {
+      queue.enqueue(i);
+      persistent.enqueue(i);
+    }
+
+    unsigned n = rounds * 10u / length + 10u;
+    double tQueue = monitor(queue, n, sink);
+    double tPersistent = monitor(persistent, rounds * 100u, sink);
+
+    cout << length << "\t  " << tQueue << "\t " << tPersistent << endl;
+  }
+
+  // keep the results live
+  if (sink == 1.0) {
+    cout << sink << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "DLL.h"
+#include "ParallelDLL.h"
+#include "ThreadPool.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Fill a list from a vector.
+ */
+void fill(DLL<int> &list, const vector<int> &keys) {
+  list.clear();
+  for (size_t i = 0u; i < keys.size(); i++) {
+    list.addLast(keys[i]);
+  }
+}
+
+/**
+ * The approach being replaced: copy into a vector, sort that, and
+ * rebuild the list, allocating every node again.
+ */
+void copySortRebuild(DLL<int> &list) {
+  vector<int> v;
+  v.reserve(list.size());
+  for (DLL<int>::Iterator it = list.begin(); it != list.end(); ++it) {
+    v.push_back(*it);
+  }
+  stable_sort(v.begin(), v.end());
+  list.clear();
+  for (size_t i = 0u; i < v.size(); i++) {
+    list.addLast(v[i]);
+  }
+}
+
+/**
+ * Benchmark of DLL::sort and parallelSort against copy-sort-rebuild,
+ * for several input orders. POSIX only, since it forks.
+ *
+ * Usage: BenchSortDLL [n]
+ */
+int main(int argc, char *argv[]) {
+  unsigned n = argc > 1 ? strtoul(argv[1], 0, 10) : 1000000u;
+  mt19937 gen(246);
+
+  vector<int> random(n), sorted(n), nearly(n), reversed(n);
+  for (unsigned i = 0u; i < n; i++) {
+    random[i] = static_cast<int>(gen() % n);
+    sorted[i] = static_cast<int>(i);
+    reversed[i] = static_cast<int>(n - i);
+  }
+  nearly = sorted;
+  for (unsigned i = 0u; i < n / 100u; i++) {
+    swap(nearly[gen() % n], nearly[gen() % n]);
+  }
+
+  const vector<int> *inputs[] = {&random, &sorted, &nearly, &reversed};
+  const char *names[] = {"random  ", "sorted  ", "nearly  ", "reversed"};
+
+  cout << n << " ints; times in ms" << endl;
+  cout << "input     copy-sort-rebuild  DLL::sort  parallelSort(4)" << endl;
+
+  for (int k = 0; k < 4; k++) {
+    cout << names[k];
+
+    for (int method = 0; method < 3; method++) {
+      // where the allocator puts nodes depends on what earlier runs freed,
+      // and traversal time depends on where nodes are, so every case
+      // builds its list in a fresh child process
+      int fds[2];
+      if (pipe(fds) != 0) {
+        return EXIT_FAILURE;
+      }
+      cout.flush();
+      pid_t pid = fork();
+      if (pid == 0) {
+        DLL<int> list;
+        fill(list, *inputs[k]);
+        steady_clock::time_point start = steady_clock::now();
+        if (method == 0) {
+          copySortRebuild(list);
+        } else if (method == 1) {
+          list.sort();
+        } else {
+          ThreadPool pool(4u);
+          parallelSort(pool, list, less<int>());
+        }
+        double ms =
+            duration<double, milli>(steady_clock::now() - start).count();
+        ssize_t written = write(fds[1], &ms, sizeof(ms));
+        _exit(written == sizeof(ms) ? 0 : 1);
+      }
+      double ms = -1.0;
+      ssize_t got = read(fds[0], &ms, sizeof(ms));
+      waitpid(pid, 0, 0);
+      close(fds[0]);
+      close(fds[1]);
+
+      cout << (method == 0 ? "  " : "\t     ")
+           << (got == sizeof(ms) ? ms : -1.0);
+    }
+    cout << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
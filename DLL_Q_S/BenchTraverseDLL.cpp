@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "DLL.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/** Sink for results, so they are not optimized away. */
+static volatile uint64_t sink;
+
+/**
+ * Write a buffer larger than the last level cache, so that the list
+ * starts out cold.
+ */
+void evictCaches() {
+  static vector<char> junk(size_t(64u) << 20);
+  for (size_t i = 0u; i < junk.size(); i += 64u) {
+    junk[i]++;
+  }
+}
+
+/**
+ * Make a list of n elements whose traversal order is unrelated to
+ * their order in memory: nodes are allocated in order, then sorted by
+ * a random key.
+ */
+DLL<uint64_t> scatteredList(size_t n) {
+  mt19937_64 gen(41);
+  DLL<uint64_t> list;
+  for (size_t i = 0u; i < n; i++) {
+    list.addLast(gen() >> 1);
+  }
+  list.sort();
+  return list;
+}
+
+/**
+ * Time one run of f on a cold cache, in ns per element.
+ */
+template <class F> double coldNs(size_t n, F f) {
+  evictCaches();
+  steady_clock::time_point t0 = steady_clock::now();
+  f();
+  return duration<double, nano>(steady_clock::now() - t0).count() / n;
+}
+
+/**
+ * Benchmark of the internal traversals of DLL (accumulate, findIf,
+ * contains, operator<< and clear) against the equivalent iterator
+ * loops, on lists that start out of cache and whose nodes are
+ * scattered in memory.
+ *
+ * Usage: BenchTraverseDLL [n]
+ */
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? strtoull(argv[1], 0, 10) : 4000000u;
+
+  DLL<uint64_t> list = scatteredList(n);
+  uint64_t last = list.getLast();
+
+  cout << n << " scattered elements, cold cache, ns per element" << endl;
+  cout << "operation    iterator  internal" << endl;
+
+  double ext = coldNs(n, [&list]() {
+    uint64_t sum = 0u;
+    for (DLL<uint64_t>::ConstIterator it = list.cbegin(); it != list.cend();
+         ++it) {
+      sum += *it;
+    }
+    sink = sum;
+  });
+  double in = coldNs(n, [&list]() {
+    sink = list.accumulate(uint64_t(0u),
+                           [](uint64_t a, uint64_t d) { return a + d; });
+  });
+  cout << "sum          " << ext << "\t  " << in << endl;
+
+  ext = coldNs(n, [&list, last]() {
+    sink = *find_if(list.cbegin(), list.cend(),
+                    [last](uint64_t d) { return d == last; });
+  });
+  in = coldNs(n, [&list, last]() {
+    const DLL<uint64_t> &constList = list;
+    sink = *constList.findIf([last](uint64_t d) { return d == last; });
+  });
+  cout << "find last    " << ext << "\t  " << in << endl;
+
+  // keys are below 2^63, so this one is absent and every node is read
+  const uint64_t absent = uint64_t(1u) << 63;
+  ext = coldNs(n, [&list, absent]() {
+    sink = find(list.cbegin(), list.cend(), absent) == list.cend();
+  });
+  in = coldNs(n, [&list, absent]() { sink = list.contains(absent); });
+  cout << "contains     " << ext << "\t  " << in << endl;
+
+  ext = coldNs(n, [&list]() {
+    ostringstream out;
+    out << "[";
+    for (DLL<uint64_t>::ConstIterator it = list.cbegin(); it != list.cend();
+         ++it) {
+      if (it != list.cbegin()) {
+        out << ", ";
+      }
+      out << *it;
+    }
+    out << "]";
+    sink = out.str().size();
+  });
+  in = coldNs(n, [&list]() {
+    ostringstream out;
+    out << list;
+    sink = out.str().size();
+  });
+  cout << "print        " << ext << "\t  " << in << endl;
+
+  DLL<uint64_t> other = scatteredList(n);
+  ext = coldNs(n, [&other]() {
+    while (!other.isEmpty()) {
+      other.removeFirst();
+    }
+  });
+  in = coldNs(n, [&list]() { list.clear(); });
+  cout << "clear        " << ext << "\t  " << in << endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,519 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a templated, thread-safe queue with a fixed
+ * capacity, for producer / consumer pipelines. Elements are stored in a
+ * ring buffer allocated once up front, so memory stays bounded no matter
+ * how far producers get ahead: when the queue is full, enqueue blocks
+ * (backpressure), and when it is empty, dequeue blocks instead of
+ * throwing the way Queue::dequeue does.
+ *
+ * close() shuts the queue down: blocked and future enqueues fail, and
+ * dequeues drain the remaining elements and then fail, so consumers can
+ * loop on "while (q.dequeue(x))".
+ *
+ * The lock is held only to move elements in or out of the buffer;
+ * waiting threads are notified after it is released, and only when some
+ * thread is actually waiting.
+ */
+template <class T> class BoundedQueue {
+public:
+  /**
+   * Constructor. Make a new, empty, open queue.
+   *
+   * \param capacity Maximum number of elements the queue holds; at
+   * least 1.
+   */
+  explicit BoundedQueue(unsigned capacity);
+
+  /**
+   * Get the maximum number of elements the queue holds.
+   *
+   * \return Capacity of the queue.
+   */
+  unsigned capacity() const { return static_cast<unsigned>(buffer.size()); }
+
+  /**
+   * Close the queue, waking every blocked thread. Elements already in
+   * the queue can still be dequeued.
+   */
+  void close();
+
+  /**
+   * Remove the first element from the queue, waiting while it is empty.
+   *
+   * \param a Set to the element removed.
+   *
+   * \return true if an element was removed, false if the queue is closed
+   * and empty.
+   */
+  bool dequeue(T &a);
+
+  /**
+   * Remove up to max elements from the queue under one lock, waiting
+   * while it is empty.
+   *
+   * \param out Array to store the removed elements in.
+   *
+   * \param max Maximum number of elements to remove.
+   *
+   * \return Number of elements removed; 0 only if the queue is closed
+   * and empty.
+   */
+  unsigned dequeueBatch(T *out, unsigned max);
+
+  /**
+   * Remove the first element from the queue, waiting at most timeout for
+   * one to arrive.
+   *
+   * \param a Set to the element removed.
+   *
+   * \param timeout Maximum time to wait.
+   *
+   * \return true if an element was removed, false on timeout or if the
+   * queue is closed and empty.
+   */
+  template <class Rep, class Period>
+  bool dequeueFor(T &a, const std::chrono::duration<Rep, Period> &timeout);
+
+  /**
+   * Add an element to the end of the queue, waiting while it is full.
+   *
+   * \param a Element to add to the queue.
+   *
+   * \return true if the element was added, false if the queue is closed.
+   */
+  bool enqueue(const T &a);
+
+  /**
+   * Add count elements to the end of the queue, in order, taking the
+   * lock once for as many as fit each time space frees up.
+   *
+   * \param items Array of elements to add.
+   *
+   * \param count Number of elements to add.
+   *
+   * \return Number of elements added; less than count only if the queue
+   * was closed.
+   */
+  unsigned enqueueBatch(const T *items, unsigned count);
+
+  /**
+   * Add an element to the end of the queue, waiting at most timeout for
+   * space.
+   *
+   * \param a Element to add to the queue.
+   *
+   * \param timeout Maximum time to wait.
+   *
+   * \return true if the element was added, false on timeout or if the
+   * queue is closed.
+   */
+  template <class Rep, class Period>
+  bool enqueueFor(const T &a,
+                  const std::chrono::duration<Rep, Period> &timeout);
+
+  /**
+   * Determine if the queue has been closed.
+   *
+   * \return True if close() has been called, false otherwise.
+   */
+  bool isClosed() const;
+
+  /**
+   * Determine if this queue is empty.
+   *
+   * \return True if the queue is empty, false otherwise.
+   */
+  bool isEmpty() const { return size() == 0u; }
+
+  /**
+   * Get the number of elements in the queue. With other threads running
+   * this is only a snapshot.
+   *
+   * \return Number of elements in the queue.
+   */
+  unsigned size() const;
+
+  /**
+   * Remove the first element from the queue without waiting.
+   *
+   * \param a Set to the element removed.
+   *
+   * \return true if an element was removed, false if the queue is empty.
+   */
+  bool tryDequeue(T &a);
+
+  /**
+   * Add an element to the end of the queue without waiting.
+   *
+   * \param a Element to add to the queue.
+   *
+   * \return true if the element was added, false if the queue is full or
+   * closed.
+   */
+  bool tryEnqueue(const T &a);
+
+  /**
+   * Override of the stream insertion operator for BoundedQueue objects.
+   *
+   * \param out ostream object to output to, e.g., cout
+   *
+   * \param queue BoundedQueue to output
+   *
+   * \return the out ostream object
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const BoundedQueue<T> &queue) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    out << "[";
+
+    for (unsigned i = 0u; i < queue.n; i++) {
+      out << queue.buffer[(queue.head + i) % queue.buffer.size()];
+
+      if (i + 1u < queue.n) {
+        out << ", ";
+      }
+    }
+
+    out << "]";
+
+    return out;
+  }
+
+private:
+  // the queue owns a mutex and waiting threads, so it cannot be copied
+  BoundedQueue(const BoundedQueue<T> &);
+  BoundedQueue<T> &operator=(const BoundedQueue<T> &);
+
+  /** Ring buffer holding the elements. */
+  std::vector<T> buffer;
+
+  /** Index of the first element in the buffer. */
+  unsigned head;
+
+  /** Number of elements in the buffer. */
+  unsigned n;
+
+  /** Number of threads waiting in dequeue. */
+  unsigned waitingConsumers;
+
+  /** Number of threads waiting in enqueue. */
+  unsigned waitingProducers;
+
+  /** True once close() has been called. */
+  bool closed;
+
+  /** Lock protecting every field above. */
+  mutable std::mutex mutex;
+
+  /** Signaled when elements are added or the queue is closed. */
+  std::condition_variable notEmpty;
+
+  /** Signaled when elements are removed or the queue is closed. */
+  std::condition_variable notFull;
+
+  /**
+   * Append an element; the lock must be held and the buffer not full.
+   * Callers copy the element before taking the lock and move it in here.
+   */
+  void push(T &a) {
+    buffer[(head + n) % buffer.size()] = std::move(a);
+    n++;
+  }
+
+  /**
+   * Remove the first element; the lock must be held and the buffer not
+   * empty.
+   */
+  void pop(T &a) {
+    a = std::move(buffer[head]);
+    head = (head + 1u) % buffer.size();
+    n--;
+  }
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the constructor.
+ */
+template <class T>
+BoundedQueue<T>::BoundedQueue(unsigned capacity)
+    : buffer(capacity), head(0u), n(0u), waitingConsumers(0u),
+      waitingProducers(0u), closed(false) {
+  if (capacity == 0u) {
+    throw std::invalid_argument("Zero capacity in "
+                                "BoundedQueue::BoundedQueue()");
+  }
+}
+
+/*
+ * Implementation of the close method.
+ */
+template <class T> void BoundedQueue<T>::close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+  }
+  notEmpty.notify_all();
+  notFull.notify_all();
+}
+
+/*
+ * Implementation of the blocking dequeue method.
+ */
+template <class T> bool BoundedQueue<T>::dequeue(T &a) {
+  bool wake;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (n == 0u && !closed) {
+      waitingConsumers++;
+      notEmpty.wait(lock);
+      waitingConsumers--;
+    }
+    if (n == 0u) {
+      return false;
+    }
+    pop(a);
+    wake = waitingProducers > 0u;
+  }
+  if (wake) {
+    notFull.notify_one();
+  }
+  return true;
+}
+
+/*
+ * Implementation of the batch dequeue method.
+ */
+template <class T>
+unsigned BoundedQueue<T>::dequeueBatch(T *out, unsigned max) {
+  unsigned count = 0u;
+  bool wake;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (n == 0u && !closed) {
+      waitingConsumers++;
+      notEmpty.wait(lock);
+      waitingConsumers--;
+    }
+    while (count < max && n > 0u) {
+      pop(out[count++]);
+    }
+    wake = count > 0u && waitingProducers > 0u;
+  }
+  if (wake) {
+    notFull.notify_all();
+  }
+  return count;
+}
+
+/*
+ * Implementation of the timed dequeue method.
+ */
+template <class T>
+template <class Rep, class Period>
+bool BoundedQueue<T>::dequeueFor(
+    T &a, const std::chrono::duration<Rep, Period> &timeout) {
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + timeout;
+  bool wake;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (n == 0u && !closed) {
+      waitingConsumers++;
+      std::cv_status status = notEmpty.wait_until(lock, deadline);
+      waitingConsumers--;
+      if (status == std::cv_status::timeout && n == 0u) {
+        return false;
+      }
+    }
+    if (n == 0u) {
+      return false;
+    }
+    pop(a);
+    wake = waitingProducers > 0u;
+  }
+  if (wake) {
+    notFull.notify_one();
+  }
+  return true;
+}
+
+/*
+ * Implementation of the blocking enqueue method.
+ */
+template <class T> bool BoundedQueue<T>::enqueue(const T &a) {
+  T item(a);
+  bool wake;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (n == buffer.size() && !closed) {
+      waitingProducers++;
+      notFull.wait(lock);
+      waitingProducers--;
+    }
+    if (closed) {
+      return false;
+    }
+    push(item);
+    wake = waitingConsumers > 0u;
+  }
+  if (wake) {
+    notEmpty.notify_one();
+  }
+  return true;
+}
+
+/*
+ * Implementation of the batch enqueue method. Up to a queue's worth of
+ * elements is copied into staged before the lock is taken, and only
+ * moved in under it; done counts the elements actually enqueued.
+ */
+template <class T>
+unsigned BoundedQueue<T>::enqueueBatch(const T *items, unsigned count) {
+  std::vector<T> staged;
+  std::size_t next = 0u;
+  unsigned done = 0u;
+
+  staged.reserve(std::min<std::size_t>(count, buffer.size()));
+  while (done < count) {
+    if (next == staged.size()) {
+      staged.clear();
+      next = 0u;
+      for (unsigned i = done; i < count && staged.size() < buffer.size();
+           i++) {
+        staged.push_back(items[i]);
+      }
+    }
+
+    bool wake;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (n == buffer.size() && !closed) {
+        waitingProducers++;
+        notFull.wait(lock);
+        waitingProducers--;
+      }
+      if (closed) {
+        break;
+      }
+      while (next < staged.size() && n < buffer.size()) {
+        push(staged[next]);
+        next++;
+        done++;
+      }
+      wake = waitingConsumers > 0u;
+    }
+    if (wake) {
+      notEmpty.notify_all();
+    }
+  }
+
+  return done;
+}
+
+/*
+ * Implementation of the timed enqueue method.
+ */
+template <class T>
+template <class Rep, class Period>
+bool BoundedQueue<T>::enqueueFor(
+    const T &a, const std::chrono::duration<Rep, Period> &timeout) {
+  T item(a);
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + timeout;
+  bool wake;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (n == buffer.size() && !closed) {
+      waitingProducers++;
+      std::cv_status status = notFull.wait_until(lock, deadline);
+      waitingProducers--;
+      if (status == std::cv_status::timeout && n == buffer.size()) {
+        return false;
+      }
+    }
+    if (closed) {
+      return false;
+    }
+    push(item);
+    wake = waitingConsumers > 0u;
+  }
+  if (wake) {
+    notEmpty.notify_one();
+  }
+  return true;
+}
+
+/*
+ * Implementation of the isClosed method.
+ */
+template <class T> bool BoundedQueue<T>::isClosed() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return closed;
+}
+
+/*
+ * Implementation of the size method.
+ */
+template <class T> unsigned BoundedQueue<T>::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return n;
+}
+
+/*
+ * Implementation of the non-blocking dequeue method.
+ */
+template <class T> bool BoundedQueue<T>::tryDequeue(T &a) {
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (n == 0u) {
+      return false;
+    }
+    pop(a);
+    wake = waitingProducers > 0u;
+  }
+  if (wake) {
+    notFull.notify_one();
+  }
+  return true;
+}
+
+/*
+ * Implementation of the non-blocking enqueue method.
+ */
+template <class T> bool BoundedQueue<T>::tryEnqueue(const T &a) {
+  T item(a);
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed || n == buffer.size()) {
+      return false;
+    }
+    push(item);
+    wake = waitingConsumers > 0u;
+  }
+  if (wake) {
+    notEmpty.notify_one();
+  }
+  return true;
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include "Queue.h"
+#include "Scheduler.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a bounded channel between coroutines, using a
+ * Queue as the underlying buffer. Inside a Task,
+ *
+ *   bool ok = co_await channel.enqueue(x);
+ *   std::optional<T> y = co_await channel.dequeue();
+ *
+ * suspend the coroutine, rather than blocking a thread, while the
+ * channel is full or empty; the coroutine is handed back to the
+ * channel's Scheduler when another coroutine makes room or supplies a
+ * value. A capacity of 0 makes every enqueue wait for a matching
+ * dequeue.
+ *
+ * close() wakes every waiting coroutine: enqueues then yield false, and
+ * dequeues drain the buffer and then yield an empty optional.
+ *
+ * All operations take a lock, so a channel may be shared by coroutines
+ * running on a ThreadPoolScheduler.
+ */
+template <class T> class Channel {
+public:
+  //-------------------------------------------------------
+  // inner class definitions
+  //-------------------------------------------------------
+
+  /**
+   * Awaitable returned by dequeue(); co_await yields the element, or an
+   * empty optional once the channel is closed and drained.
+   */
+  class DequeueAwaiter {
+  public:
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h);
+    std::optional<T> await_resume() { return std::move(value); }
+
+    // make us a friend of the outer class
+    friend class Channel;
+
+  private:
+    DequeueAwaiter(Channel &ch) : ch(ch) {}
+
+    /** Channel to take from. */
+    Channel &ch;
+
+    /** Suspended coroutine, while waiting. */
+    std::coroutine_handle<> handle;
+
+    /** Element received. */
+    std::optional<T> value;
+  };
+
+  /**
+   * Awaitable returned by enqueue(); co_await yields true once the
+   * element is in the channel, or false if the channel was closed.
+   */
+  class EnqueueAwaiter {
+  public:
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h);
+    bool await_resume() const { return ok; }
+
+    // make us a friend of the outer class
+    friend class Channel;
+
+  private:
+    EnqueueAwaiter(Channel &ch, const T &a) : ch(ch), value(a), ok(false) {}
+
+    /** Channel to add to. */
+    Channel &ch;
+
+    /** Suspended coroutine, while waiting. */
+    std::coroutine_handle<> handle;
+
+    /** Element to add. */
+    T value;
+
+    /** Result of the enqueue. */
+    bool ok;
+  };
+
+  /**
+   * Constructor. Make a new, empty, open channel.
+   *
+   * \param scheduler Scheduler that resumes coroutines woken by this
+   * channel.
+   *
+   * \param capacity Number of elements buffered before enqueue waits.
+   */
+  Channel(Scheduler &scheduler, unsigned capacity)
+      : scheduler(scheduler), cap(capacity), closed(false) {}
+
+  /**
+   * Get the number of elements buffered before enqueue waits.
+   *
+   * \return Capacity of the channel.
+   */
+  unsigned capacity() const { return cap; }
+
+  /**
+   * Close the channel, waking every waiting coroutine.
+   */
+  void close();
+
+  /**
+   * Remove the first element from the channel; co_await the result.
+   *
+   * \return Awaitable yielding the element, or an empty optional if the
+   * channel is closed and empty.
+   */
+  DequeueAwaiter dequeue() { return DequeueAwaiter(*this); }
+
+  /**
+   * Add an element to the end of the channel; co_await the result.
+   *
+   * \param a Element to add.
+   *
+   * \return Awaitable yielding true once the element is added, false if
+   * the channel is closed.
+   */
+  EnqueueAwaiter enqueue(const T &a) { return EnqueueAwaiter(*this, a); }
+
+  /**
+   * Get the number of buffered elements.
+   *
+   * \return Number of elements in the channel.
+   */
+  unsigned size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buffer.size();
+  }
+
+private:
+  Channel(const Channel &) = delete;
+  Channel &operator=(const Channel &) = delete;
+
+  /** Scheduler that resumes woken coroutines. */
+  Scheduler &scheduler;
+
+  /** Maximum number of buffered elements. */
+  unsigned cap;
+
+  /** True once close() has been called. */
+  bool closed;
+
+  /** Buffered elements. */
+  Queue<T> buffer;
+
+  /** Coroutines waiting for an element, oldest first. */
+  Queue<DequeueAwaiter *> consumers;
+
+  /** Coroutines waiting for room, oldest first. */
+  Queue<EnqueueAwaiter *> producers;
+
+  /** Lock protecting everything above except scheduler and cap. */
+  mutable std::mutex mutex;
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Suspend point of dequeue: take an element if one is available,
+ * otherwise join the consumer queue. Returning false resumes the caller
+ * at once, without a trip through the scheduler.
+ */
+template <class T>
+bool Channel<T>::DequeueAwaiter::await_suspend(std::coroutine_handle<> h) {
+  EnqueueAwaiter *pProducer = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(ch.mutex);
+
+    if (!ch.buffer.isEmpty()) {
+      value = ch.buffer.dequeue();
+      // a waiting producer's element fills the slot just freed
+      if (!ch.producers.isEmpty()) {
+        pProducer = ch.producers.dequeue();
+        ch.buffer.enqueue(pProducer->value);
+        pProducer->ok = true;
+      }
+    } else if (!ch.producers.isEmpty()) {
+      // unbuffered: take the element straight from a waiting producer
+      pProducer = ch.producers.dequeue();
+      value = std::move(pProducer->value);
+      pProducer->ok = true;
+    } else if (!ch.closed) {
+      handle = h;
+      ch.consumers.enqueue(this);
+      return true;
+    }
+  }
+
+  if (pProducer != nullptr) {
+    ch.scheduler.schedule(pProducer->handle);
+  }
+  return false;
+}
+
+/*
+ * Suspend point of enqueue: hand the element to a waiting consumer or
+ * buffer it if there is room, otherwise join the producer queue.
+ */
+template <class T>
+bool Channel<T>::EnqueueAwaiter::await_suspend(std::coroutine_handle<> h) {
+  DequeueAwaiter *pConsumer = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(ch.mutex);
+
+    if (ch.closed) {
+      ok = false;
+      return false;
+    } else if (!ch.consumers.isEmpty()) {
+      pConsumer = ch.consumers.dequeue();
+      pConsumer->value = std::move(value);
+    } else if (ch.buffer.size() < ch.cap) {
+      ch.buffer.enqueue(value);
+    } else {
+      handle = h;
+      ch.producers.enqueue(this);
+      return true;
+    }
+    ok = true;
+  }
+
+  if (pConsumer != nullptr) {
+    ch.scheduler.schedule(pConsumer->handle);
+  }
+  return false;
+}
+
+/*
+ * Implementation of close.
+ */
+template <class T> void Channel<T>::close() {
+  Queue<DequeueAwaiter *> wakeConsumers;
+  Queue<EnqueueAwaiter *> wakeProducers;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    wakeConsumers = consumers;
+    wakeProducers = producers;
+    consumers.clear();
+    producers.clear();
+  }
+
+  // consumers only wait on an empty buffer, so they get nothing
+  while (!wakeConsumers.isEmpty()) {
+    scheduler.schedule(wakeConsumers.dequeue()->handle);
+  }
+  while (!wakeProducers.isEmpty()) {
+    EnqueueAwaiter *pProducer = wakeProducers.dequeue();
+    pProducer->ok = false;
+    scheduler.schedule(pProducer->handle);
+  }
+}
@@ -1,612 +1,1382 @@
-#pragma once
-
-#include <iostream>
-#include <stdexcept>
-
-//-----------------------------------------------------------
-// class definitions
-//-----------------------------------------------------------
-
-/**
- * Class representing a templated doubly-linked list, with an
- * iterator and ability to add / remove at both ends.
- */
-template <class T> class DLL {
-private:
-  //-------------------------------------------------------
-  // inner class definition
-  //-------------------------------------------------------
-
-  /**
-   * Private nested class representing nodes in the doubly-linked
-   * list.
-   */
-  class Node {
-  public:
-    /**
-     * Default constructor. Make a new Node with default data
-     * and pointers set to zero.
-     */
-    Node() : data(), pPrev(0), pNext(0) {}
-
-    /**
-     * Initializing constructor. Make a new Node with the specified
-     * data and pointer values.
-     *
-     * \param d Data value of type T for the Node.
-     *
-     * \param pN Pointer to the next Node in the list, or 0 if this
-     * is the last Node.
-     *
-     * \param pP Pointer to the previous Node in the list, or 0 if
-     * this is the first Node.
-     */
-    Node(T d, Node *pP, Node *pN) : data(d), pPrev(pP), pNext(pN) {}
-
-    /** Type T payload of the Node. */
-    T data;
-
-    /** Pointer to the previous node in the list. */
-    Node *pPrev;
-
-    /** Pointer to the next node in the list. */
-    Node *pNext;
-  };
-
-public:
-  //-------------------------------------------------------
-  // inner class definition
-  //-------------------------------------------------------
-
-  /**
-   * Iterator for the doubly-linked list class.
-   */
-  class Iterator {
-  public:
-    /** Dereferencing operator to allow access to the node's
-     * data. */
-    T &operator*();
-
-    /** Equality operator to test if this iterator is at another's
-     * position. */
-    bool operator==(const Iterator &other) const {
-      return pCurr == other.pCurr;
-    }
-
-    /** Inequality operator to test if this iterator is not at
-     * another's position. */
-    bool operator!=(const Iterator &other) const {
-      return pCurr != other.pCurr;
-    }
-
-    /** Increment operator to advance to next element. */
-    Iterator &operator++();
-
-    /** Decrement operator to retreat to previous element. */
-    Iterator &operator--();
-
-    // make us a friend of the outer class
-    friend class DLL;
-
-  private:
-    /** Current iterator location. */
-    Node *pCurr;
-
-    /** Private constructor can't be accessed outside of DLL
-     * class. */
-    Iterator(Node *pC) : pCurr(pC) {}
-  };
-
-public:
-  /**
-   * Default constructor; create an empty list.
-   */
-  DLL() : pHead(0), pTail(0), n(0u) {}
-
-  /**
-   * Copy constructor; make this list just like an existing one.
-   *
-   * \param list Doubly-linked list to copy.
-   */
-  DLL(const DLL<T> &list);
-
-  /**
-   * Destructor. Destroy the list.
-   */
-  ~DLL() { clear(); }
-
-  /**
-   * Add an element to the front of the list.
-   *
-   * \param d Element to add to the list.
-   */
-  void addFirst(const T &d);
-
-  /**
-   * Add an element to the end of the list.
-   *
-   * \param d Element to add to the list.
-   */
-  void addLast(const T &d);
-
-  /**
-   * Get an iterator to the first element in the list.
-   *
-   * \return Iterator positioned at the first element.
-   */
-  Iterator begin() const;
-
-  /**
-   * Remove all elements from this list.
-   */
-  void clear();
-
-  /**
-   * Determine if the list contains a specific element.
-   *
-   * \param d Element to search for.
-   *
-   * \return index of the element if found, -1 if not found.
-   */
-  int contains(const T &d) const;
-
-  /**
-   * Get an iterator to the last element in the list.
-   *
-   * \return Iterator positioned one past the last element of the
-   * list.
-   */
-  Iterator end() const;
-
-  /**
-   * Get the element at a specified position in the list.
-   *
-   * \param idx Index of element to get.
-   *
-   * \return Element as the specified position.
-   */
-  T &get(unsigned idx) const;
-
-  /**
-   * Get the first element in the list.
-   *
-   * \return First element in the list.
-   */
-  T &getFirst() const;
-
-  /**
-   * Get the last element in the list.
-   *
-   * \return Last element in the list.
-   */
-  T &getLast() const;
-
-  /**
-   * Determine if this list is empty.
-   *
-   * \return true if the list is empty, false otherwise.
-   */
-  bool isEmpty() const { return n == 0u; }
-
-  /**
-   * Remove the specified element from the list.
-   *
-   * \param idx Index of element to remove.
-   *
-   * \return Element that was in the specified position.
-   */
-  T remove(unsigned idx);
-
-  /**
-   * Remove the first element from the list.
-   *
-   * \return Element that was in the first position.
-   */
-  T removeFirst();
-
-  /**
-   * Remove the last element from the list.
-   *
-   * \return Element that was in the last position.
-   */
-  T removeLast();
-
-  /**
-   * Change the value at a specific location in the list.
-   *
-   * \param idx Index of element to change.
-   *
-   * \param d New value to place in the list.
-   */
-  void set(unsigned idx, const T &d);
-
-  /**
-   * Change the value at the first location in the list.
-   *
-   * \param d New value to place as the first element in the list.
-   */
-  void setFirst(const T &d);
-
-  /**
-   * Change the value at the last location in the list.
-   *
-   * \param d New value to place as the last element in the list.
-   */
-  void setLast(const T &d);
-
-  /**
-   * Get the number of elements in the list.
-   *
-   * \return Number of elements in the list.
-   */
-  unsigned size() const { return n; }
-
-  /**
-   * Overridden assignment operator.
-   *
-   * \param list List to copy.
-   *
-   * \return Reference to this list, for chaining.
-   */
-  DLL<T> &operator=(const DLL<T> &list);
-
-  /**
-   * Override of the stream insertion operator for DLL objects.
-   *
-   * \param out ostream object to output to, e.g., cout
-   *
-   * \param list DLL to output
-   *
-   * \return the out ostream object
-   */
-  friend std::ostream &operator<<(std::ostream &out, const DLL<T> &list) {
-
-    Node *pCurr = list.pHead;
-
-    out << "[";
-
-    while (pCurr != 0) {
-      out << pCurr->data;
-
-      if (pCurr->pNext != 0) {
-        out << ", ";
-      }
-
-      pCurr = pCurr->pNext;
-    }
-
-    out << "]";
-
-    return out;
-  }
-
-private:
-  /** Pointer to the first node in the list. */
-  Node *pHead;
-
-  /** Pointer to the last node in the list. */
-  Node *pTail;
-
-  /** Number of nodes in the list. */
-  unsigned n;
-
-  /** Private helper for copy constructor and assignment operator.
-   *
-   * \param list Reference to DLL to copy from.
-   */
-  void copy(const DLL<T> &list);
-};
-
-//-----------------------------------------------------------
-// function implementations
-//-----------------------------------------------------------
-
-/*
- * Implementation of the Iterator dereferencing operator.
- */
-template <class T> T &DLL<T>::Iterator::operator*() {
-  if (pCurr == 0) {
-    throw std::out_of_range("Dereferencing null Iterator in "
-                            "DLL::Iterator::operator*()");
-  }
-
-  return pCurr->data;
-}
-
-/*
- * Implementation of assignment operator.
- */
-template <class T> DLL<T> &DLL<T>::operator=(const DLL<T> &list) {
-  copy(list);
-
-  return *this;
-}
-
-/*
- * Copy constructor implementation.
- */
-template <class T> DLL<T>::DLL(const DLL<T> &list) : pHead(0), pTail(0), n(0u) {
-  copy(list);
-}
-
-/*
- * Implementation of the Iterator increment operator.
- */
-template <class T> typename DLL<T>::Iterator &DLL<T>::Iterator::operator++() {
-  if (pCurr == 0) {
-    throw std::out_of_range("Iterating past end of list in "
-                            "DLL::Iterator::operator++()");
-  }
-
-  pCurr = pCurr->pNext;
-
-  return *this;
-}
-
-/*
- * Implementation of the Iterator decrement operator.
- */
-template <class T> typename DLL<T>::Iterator &DLL<T>::Iterator::operator--() {
-  if (pCurr == 0) {
-    throw std::out_of_range("Iterating past end of list in "
-                            "DLL::Iterator::operator--()");
-  }
-
-  pCurr = pCurr->pPrev;
-
-  return *this;
-}
-
-/*
- * Implementation of the DLL addFirst method.
- */
-template <class T> void DLL<T>::addFirst(const T &d) {
-  Node *pN = new Node(d, 0, pHead);
-
-  if (pHead == 0) {
-    // empty list case
-    pHead = pTail = pN;
-  } else {
-    // non-empty list case
-    pHead = pN;
-    pHead->pNext->pPrev = pHead;
-  }
-
-  n++;
-}
-
-/*
- * Implementation of the DLL addLast method.
- */
-template <class T> void DLL<T>::addLast(const T &d) {
-  Node *pN = new Node(d, pTail, 0);
-
-  if (pHead == 0) {
-    // empty list case
-    pHead = pTail = pN;
-  } else {
-    // non-empty list case
-    pTail = pN;
-    pTail->pPrev->pNext = pTail;
-  }
-
-  n++;
-}
-
-/*
- * Get iterator to the first node.
- */
-template <class T> typename DLL<T>::Iterator DLL<T>::begin() const {
-  return Iterator(pHead);
-}
-
-/*
- * Implementation of the DLL clear method.
- */
-template <class T> void DLL<T>::clear() {
-  Node *pCurr = pHead;
-
-  while (pCurr != 0) {
-    Node *pT = pCurr;
-    pCurr = pCurr->pNext;
-    delete pT;
-  }
-
-  pHead = pTail = 0;
-  n = 0u;
-}
-
-/*
- * Search for an element in the list.
- */
-template <class T> int DLL<T>::contains(const T &d) const {
-  Node *pCurr = pHead;
-  int i = 0;
-
-  while (pCurr != 0) {
-    if (pCurr->data == d) {
-      return i;
-    }
-    pCurr = pCurr->pNext;
-    i++;
-  }
-
-  return -1;
-}
-
-/*
- * Copy helper method implementation.
- */
-template <class T> void DLL<T>::copy(const DLL<T> &list) {
-  clear();
-
-  for (DLL<T>::Iterator i = list.begin(); i != list.end(); ++i) {
-    addLast(*i);
-  }
-}
-
-/*
- * Get iterator to the end of the list.
- */
-template <class T> typename DLL<T>::Iterator DLL<T>::end() const {
-  return Iterator(0);
-}
-
-/*
- * Get specified element from the list.
- */
-template <class T> T &DLL<T>::get(unsigned idx) const {
-  if (idx >= n) {
-    throw std::out_of_range("Index beyond end of list in "
-                            "DLL::get()");
-  }
-
-  Node *pCurr = pHead;
-  for (unsigned i = 0u; i < idx; i++) {
-    pCurr = pCurr->pNext;
-  }
-
-  return pCurr->data;
-}
-
-/*
- * Get the first element in the list.
- */
-template <class T> T &DLL<T>::getFirst() const {
-  if (n == 0) {
-    throw std::out_of_range("Empty list in DLL::getFirst()");
-  }
-
-  return pHead->data;
-}
-
-/*
- * Get the last element in the list.
- */
-template <class T> T &DLL<T>::getLast() const {
-  if (n == 0) {
-    throw std::out_of_range("Empty list in DLL::getLast()");
-  }
-
-  return pTail->data;
-}
-
-/*
- * Remove specified element.
- */
-template <class T> T DLL<T>::remove(unsigned idx) {
-  if (idx >= n) {
-    throw std::out_of_range("Remove past list bounds in "
-                            "DLL::remove()");
-  }
-
-  if (idx == 0u) {
-    return removeFirst();
-  } else if (idx == (n - 1u)) {
-    return removeLast();
-  } else {
-    Node *pCurr = pHead;
-    for (unsigned i = 0u; i < idx; i++) {
-      pCurr = pCurr->pNext;
-    }
-    T d = pCurr->data;
-
-    pCurr->pPrev->pNext = pCurr->pNext;
-    pCurr->pNext->pPrev = pCurr->pPrev;
-
-    delete pCurr;
-
-    return d;
-  }
-}
-
-/*
- * Remove first element from list.
- */
-template <class T> T DLL<T>::removeFirst() {
-  if (n == 0) {
-    throw std::out_of_range("Empty list in DLL::removeFirst()");
-  }
-  n--;
-  T d = pHead->data;
-  Node *pT = pHead;
-
-  pHead = pHead->pNext;
-  if (pHead != 0) {
-    pHead->pPrev = 0;
-  }
-
-  if (n == 0) {
-    pHead = pTail = 0;
-  }
-
-  delete pT;
-
-  return d;
-}
-
-/*
- * Remove last element from list.
- */
-template <class T> T DLL<T>::removeLast() {
-  if (n == 0) {
-    throw std::out_of_range("Empty list in DLL::removeLast()");
-  }
-  n--;
-  Node *pT = pTail;
-  T d = pTail->data;
-
-  pTail = pTail->pPrev;
-  if (pTail != 0) {
-    pTail->pNext = 0;
-  }
-
-  if (n == 0) {
-    pHead = pTail = 0;
-  }
-
-  delete pT;
-
-  return d;
-}
-
-/*
- * Change element at a specified index.
- */
-template <class T> void DLL<T>::set(unsigned idx, const T &d) {
-  if (idx >= n) {
-    throw std::out_of_range("Access past end of list in "
-                            "DLL::set()");
-  }
-
-  Node *pCurr = pHead;
-  for (unsigned i = 0; i < idx; i++) {
-    pCurr = pCurr->pNext;
-  }
-
-  pCurr->data = d;
-}
-
-/*
- * Change element at the head of the list.
- */
-template <class T> void DLL<T>::setFirst(const T &d) {
-  if (pHead == 0) {
-    throw std::out_of_range("Set into front of empty list in "
-                            "DLL::setFirst()");
-  }
-
-  pHead->data = d;
-}
-
-/*
- * Change element at the tail of the list.
- */
-template <class T> void DLL<T>::setLast(const T &d) {
-  if (pTail == 0) {
-    throw std::out_of_range("Set into end of empty list in "
-                            "DLL::setLast()");
-  }
-
-  pTail->data = d;
-}
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include "CheckPolicy.h"
+#include "Retirer.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a templated doubly-linked list, with an
+ * iterator and ability to add / remove at both ends.
+ *
+ * \tparam T Element type.
+ *
+ * \tparam Check Checking policy from CheckPolicy.h applied to
+ * iterators, indices and operations on an empty list; Checked throws
+ * std::out_of_range.
+ *
+ * \tparam Alloc Allocator for the nodes, rebound from T. merge(),
+ * splice() and splitOff() move nodes between lists, so the lists
+ * involved must have equal allocators.
+ */
+template <class T, class Check = Checked, class Alloc = std::allocator<T> >
+class DLL {
+private:
+  //-------------------------------------------------------
+  // inner class definition
+  //-------------------------------------------------------
+
+  /**
+   * Private nested class representing nodes in the doubly-linked
+   * list.
+   */
+  class Node {
+  public:
+    /**
+     * Default constructor. Make a new Node with default data
+     * and pointers set to zero.
+     */
+    Node() : data(), pPrev(0), pNext(0) {}
+
+    /**
+     * Initializing constructor. Make a new Node with the specified
+     * data and pointer values.
+     *
+     * \param d Data value of type T for the Node.
+     *
+     * \param pN Pointer to the next Node in the list, or 0 if this
+     * is the last Node.
+     *
+     * \param pP Pointer to the previous Node in the list, or 0 if
+     * this is the first Node.
+     */
+    Node(T d, Node *pP, Node *pN) : data(d), pPrev(pP), pNext(pN) {}
+
+    /** Type T payload of the Node. */
+    T data;
+
+    /** Pointer to the previous node in the list. */
+    Node *pPrev;
+
+    /** Pointer to the next node in the list. */
+    Node *pNext;
+  };
+
+public:
+  //-------------------------------------------------------
+  // inner class definition
+  //-------------------------------------------------------
+
+  /**
+   * Bidirectional iterator for the doubly-linked list class. U is T
+   * for Iterator and const T for ConstIterator. The end iterator knows
+   * its list, so --end() moves to the last element and std algorithms,
+   * range-for and std::reverse_iterator all work.
+   */
+  template <class U> class BasicIterator {
+  public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef U *pointer;
+    typedef U &reference;
+
+    /** Default constructor; make a singular iterator. */
+    BasicIterator() : pList(0), pCurr(0) {}
+
+    /** Converting constructor; an Iterator converts to a
+     * ConstIterator. */
+    BasicIterator(const BasicIterator<T> &other)
+        : pList(other.pList), pCurr(other.pCurr) {}
+
+    /** Dereferencing operator to allow access to the node's
+     * data. */
+    U &operator*() const;
+
+    /** Member access operator. */
+    U *operator->() const { return &**this; }
+
+    /** Equality operator to test if two iterators are at the same
+     * position; Iterator and ConstIterator can be mixed. */
+    friend bool operator==(const BasicIterator &a, const BasicIterator &b) {
+      return a.pCurr == b.pCurr;
+    }
+
+    /** Inequality operator to test if two iterators are at different
+     * positions. */
+    friend bool operator!=(const BasicIterator &a, const BasicIterator &b) {
+      return a.pCurr != b.pCurr;
+    }
+
+    /** Increment operator to advance to next element. */
+    BasicIterator &operator++();
+
+    /** Postfix increment operator. */
+    BasicIterator operator++(int) {
+      BasicIterator old(*this);
+      ++*this;
+      return old;
+    }
+
+    /** Decrement operator to retreat to previous element. */
+    BasicIterator &operator--();
+
+    /** Postfix decrement operator. */
+    BasicIterator operator--(int) {
+      BasicIterator old(*this);
+      --*this;
+      return old;
+    }
+
+    // make us a friend of the outer class and of the other iterator
+    friend class DLL;
+    template <class> friend class BasicIterator;
+
+  private:
+    /** List iterated over, so that end() can be decremented. */
+    const DLL *pList;
+
+    /** Current iterator location; 0 at the end of the list. */
+    Node *pCurr;
+
+    /** Private constructor can't be accessed outside of DLL
+     * class. */
+    BasicIterator(const DLL *pL, Node *pC) : pList(pL), pCurr(pC) {}
+  };
+
+  /** Iterator over modifiable elements. */
+  typedef BasicIterator<T> Iterator;
+
+  /** Iterator over const elements. */
+  typedef BasicIterator<const T> ConstIterator;
+
+  // standard container type names
+  typedef T value_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef Iterator iterator;
+  typedef ConstIterator const_iterator;
+  typedef std::reverse_iterator<Iterator> reverse_iterator;
+  typedef std::reverse_iterator<ConstIterator> const_reverse_iterator;
+  typedef std::ptrdiff_t difference_type;
+  typedef std::size_t size_type;
+
+  /** Value returned by contains() when the element is not found. */
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+
+public:
+  /**
+   * Default constructor; create an empty list.
+   */
+  DLL() : alloc(), pHead(0), pTail(0), n(0u), pReclaimer(0) {}
+
+  /**
+   * Constructor; create an empty list whose nodes come from an
+   * allocator, e.g., an ArenaAllocator from HugePageArena.h.
+   *
+   * \param a Allocator to copy.
+   */
+  explicit DLL(const Alloc &a)
+      : alloc(a), pHead(0), pTail(0), n(0u), pReclaimer(0) {}
+
+  /**
+   * Copy constructor; make this list just like an existing one.
+   *
+   * \param list Doubly-linked list to copy.
+   */
+  DLL(const DLL<T, Check, Alloc> &list);
+
+  /**
+   * Destructor. Destroy the list.
+   */
+  ~DLL() { clear(); }
+
+  /**
+   * Fold the elements from first to last into a value.
+   *
+   * \param init Starting value.
+   *
+   * \param op Function called as op(value, element), returning the new
+   * value.
+   *
+   * \return Value after the last element.
+   */
+  template <class V, class Op> V accumulate(V init, Op op) const;
+
+  /**
+   * Add an element to the front of the list.
+   *
+   * \param d Element to add to the list.
+   */
+  void addFirst(const T &d);
+
+  /**
+   * Add an element to the end of the list.
+   *
+   * \param d Element to add to the list.
+   */
+  void addLast(const T &d);
+
+  /**
+   * Get an iterator to the first element in the list.
+   *
+   * \return Iterator positioned at the first element.
+   */
+  Iterator begin() { return Iterator(this, pHead); }
+
+  /**
+   * Get a const iterator to the first element in the list.
+   *
+   * \return ConstIterator positioned at the first element.
+   */
+  ConstIterator begin() const { return ConstIterator(this, pHead); }
+
+  /**
+   * Get a const iterator to the first element in the list.
+   *
+   * \return ConstIterator positioned at the first element.
+   */
+  ConstIterator cbegin() const { return begin(); }
+
+  /**
+   * Get a const iterator to the end of the list.
+   *
+   * \return ConstIterator positioned one past the last element.
+   */
+  ConstIterator cend() const { return end(); }
+
+  /**
+   * Remove all elements from this list; with a Retirer set, such as a
+   * Reclaimer, the nodes of a large list are freed in the background.
+   */
+  void clear();
+
+  /**
+   * Determine if the list contains a specific element.
+   *
+   * \param d Element to search for.
+   *
+   * \return index of the element if found, npos if not found.
+   */
+  std::size_t contains(const T &d) const;
+
+  /**
+   * Get a const reverse iterator to the last element in the list.
+   *
+   * \return Reverse iterator positioned at the last element.
+   */
+  const_reverse_iterator crbegin() const { return rbegin(); }
+
+  /**
+   * Get a const reverse iterator to the front end of the list.
+   *
+   * \return Reverse iterator positioned before the first element.
+   */
+  const_reverse_iterator crend() const { return rend(); }
+
+  /**
+   * Get an iterator to the end of the list.
+   *
+   * \return Iterator positioned one past the last element of the
+   * list; decrementing it gives the last element.
+   */
+  Iterator end() { return Iterator(this, 0); }
+
+  /**
+   * Get a const iterator to the end of the list.
+   *
+   * \return ConstIterator positioned one past the last element of the
+   * list.
+   */
+  ConstIterator end() const { return ConstIterator(this, 0); }
+
+  /**
+   * Find the first element satisfying a predicate. Like the other
+   * internal traversals, it walks the nodes directly, with no checks
+   * per step, prefetching the nodes ahead.
+   *
+   * \param pred Function called as pred(element), returning true for a
+   * match; it must not add or remove elements.
+   *
+   * \return Iterator at the first match, or end() if there is none.
+   */
+  template <class Pred> Iterator findIf(Pred pred);
+
+  /**
+   * Find the first element satisfying a predicate.
+   *
+   * \param pred Function called as pred(element).
+   *
+   * \return ConstIterator at the first match, or end() if there is
+   * none.
+   */
+  template <class Pred> ConstIterator findIf(Pred pred) const;
+
+  /**
+   * Call a function on every element, from first to last. Faster than
+   * an iterator loop over a large list.
+   *
+   * \param fn Function called as fn(element); it may modify the element
+   * but must not add or remove elements.
+   */
+  template <class Fn> void forEach(Fn fn);
+
+  /**
+   * Call a function on every element, from first to last.
+   *
+   * \param fn Function called as fn(element).
+   */
+  template <class Fn> void forEach(Fn fn) const;
+
+  /**
+   * Get the element at a specified position in the list.
+   *
+   * \param idx Index of element to get.
+   *
+   * \return Element as the specified position.
+   */
+  T &get(std::size_t idx) const;
+
+  /**
+   * Get the first element in the list.
+   *
+   * \return First element in the list.
+   */
+  T &getFirst() const;
+
+  /**
+   * Get the last element in the list.
+   *
+   * \return Last element in the list.
+   */
+  T &getLast() const;
+
+  /**
+   * Determine if this list is empty.
+   *
+   * \return true if the list is empty, false otherwise.
+   */
+  bool isEmpty() const { return n == 0u; }
+
+  /**
+   * Merge another sorted list into this sorted list, by relinking its
+   * nodes; afterwards the other list is empty. The merge is stable:
+   * equal elements keep their order, with this list's first.
+   *
+   * \param list Sorted list to merge in.
+   */
+  void merge(DLL<T, Check, Alloc> &list) { merge(list, std::less<T>()); }
+
+  /**
+   * Merge another list into this list, both sorted by comp.
+   *
+   * \param list Sorted list to merge in.
+   *
+   * \param comp Strict weak ordering the lists are sorted by.
+   */
+  template <class Compare> void merge(DLL<T, Check, Alloc> &list, Compare comp);
+
+  /**
+   * Get a reverse iterator to the last element in the list.
+   *
+   * \return Reverse iterator positioned at the last element.
+   */
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  /**
+   * Get a const reverse iterator to the last element in the list.
+   *
+   * \return Reverse iterator positioned at the last element.
+   */
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  /**
+   * Remove the specified element from the list.
+   *
+   * \param idx Index of element to remove.
+   *
+   * \return Element that was in the specified position.
+   */
+  T remove(std::size_t idx);
+
+  /**
+   * Remove the first element from the list.
+   *
+   * \return Element that was in the first position.
+   */
+  T removeFirst();
+
+  /**
+   * Remove the last element from the list.
+   *
+   * \return Element that was in the last position.
+   */
+  T removeLast();
+
+  /**
+   * Get a reverse iterator to the front end of the list.
+   *
+   * \return Reverse iterator positioned before the first element.
+   */
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  /**
+   * Get a const reverse iterator to the front end of the list.
+   *
+   * \return Reverse iterator positioned before the first element.
+   */
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  /**
+   * Change the value at a specific location in the list.
+   *
+   * \param idx Index of element to change.
+   *
+   * \param d New value to place in the list.
+   */
+  void set(std::size_t idx, const T &d);
+
+  /**
+   * Change the value at the first location in the list.
+   *
+   * \param d New value to place as the first element in the list.
+   */
+  void setFirst(const T &d);
+
+  /**
+   * Change the value at the last location in the list.
+   *
+   * \param d New value to place as the last element in the list.
+   */
+  void setLast(const T &d);
+
+  /**
+   * Have clear() and the destructor hand the nodes of a large list to a
+   * background thread to free, instead of freeing them before
+   * returning. Copies of the list don't inherit the setting.
+   *
+   * \param pR Retirer to use, such as a Reclaimer, which must outlive
+   * the list, or 0 to free nodes synchronously again.
+   */
+  void setReclaimer(Retirer *pR) { pReclaimer = pR; }
+
+  /**
+   * Get the number of elements in the list.
+   *
+   * \return Number of elements in the list.
+   */
+  std::size_t size() const { return n; }
+
+  /**
+   * Sort the list into ascending order with operator<.
+   */
+  void sort() { sort(std::less<T>()); }
+
+  /**
+   * Sort the list with a stable, natural merge sort that relinks the
+   * existing nodes, so it allocates nothing and copies no elements.
+   * Ascending and strictly descending runs in the input are merged as
+   * whole units, so sorted, reversed or nearly sorted lists take close
+   * to O(n); the worst case is O(n log n). comp must not throw.
+   *
+   * \param comp Strict weak ordering to sort by.
+   */
+  template <class Compare> void sort(Compare comp);
+
+  /**
+   * Move every element of another list onto the end of this one in
+   * O(1); afterwards the other list is empty.
+   *
+   * \param list List whose elements to move.
+   */
+  void splice(DLL<T, Check, Alloc> &list);
+
+  /**
+   * Move the elements from a given index to the end of the list into
+   * another list, replacing its contents.
+   *
+   * \param idx Index of the first element to move; may be size().
+   *
+   * \param rest List to receive the elements.
+   */
+  void splitOff(std::size_t idx, DLL<T, Check, Alloc> &rest);
+
+  /**
+   * Overridden assignment operator. The nodes this list already has are
+   * reused, so assigning between lists of similar length allocates
+   * little; assigning a list to itself does nothing.
+   *
+   * \param list List to copy.
+   *
+   * \return Reference to this list, for chaining.
+   */
+  DLL<T, Check, Alloc> &operator=(const DLL<T, Check, Alloc> &list);
+
+  /**
+   * Override of the stream insertion operator for DLL objects.
+   *
+   * \param out ostream object to output to, e.g., cout
+   *
+   * \param list DLL to output
+   *
+   * \return the out ostream object
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const DLL<T, Check, Alloc> &list) {
+    bool first = true;
+
+    out << "[";
+
+    list.forEach([&out, &first](const T &d) {
+      if (!first) {
+        out << ", ";
+      }
+      out << d;
+      first = false;
+    });
+
+    out << "]";
+
+    return out;
+  }
+
+private:
+  /** Allocator type for nodes. */
+  typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node>
+      NodeAlloc;
+
+  /** Allocator the nodes come from. */
+  NodeAlloc alloc;
+
+  /** Pointer to the first node in the list. */
+  Node *pHead;
+
+  /** Pointer to the last node in the list. */
+  Node *pTail;
+
+  /** Number of nodes in the list. */
+  std::size_t n;
+
+  /** Retirer freeing large lists in the background, or 0. */
+  Retirer *pReclaimer;
+
+  /**
+   * Allocate and construct a node.
+   *
+   * \return Pointer to the new node.
+   */
+  Node *newNode(const T &d, Node *pP, Node *pN);
+
+  /**
+   * Destroy and free a node made by newNode.
+   */
+  void deleteNode(Node *pN) { deleteNode(alloc, pN); }
+
+  /**
+   * Destroy and free a node with a given allocator.
+   */
+  static void deleteNode(NodeAlloc &a, Node *pN);
+
+  /**
+   * Private helper for clear; free a chain of nodes from both ends at
+   * once, so the loads of the two ends overlap.
+   *
+   * \param a Allocator the nodes came from.
+   *
+   * \param pFront First node of the chain.
+   *
+   * \param pBack Last node of the chain.
+   *
+   * \param count Number of nodes in the chain.
+   */
+  static void freeChain(NodeAlloc &a, Node *pFront, Node *pBack,
+                        std::size_t count);
+
+  /** Private helper for copy constructor and assignment operator.
+   *
+   * \param list Reference to DLL to copy from.
+   */
+  void copy(const DLL<T, Check, Alloc> &list);
+
+  /**
+   * Private helper for sort; cut the run at the front of a chain of
+   * nodes, reversing it if it is descending.
+   *
+   * \param pRest First node of the chain; set to the node after the run.
+   *
+   * \param comp Strict weak ordering to sort by.
+   *
+   * \return First node of the run, now a null-terminated chain.
+   */
+  template <class Compare>
+  static Node *takeRun(Node *&pRest, Compare &comp);
+
+  /**
+   * Private helper for sort and merge; stably merge two null-terminated
+   * chains of nodes, ignoring their pPrev pointers.
+   *
+   * \param pA First node of the first chain.
+   *
+   * \param pB First node of the second chain.
+   *
+   * \param comp Strict weak ordering to merge by.
+   *
+   * \return First node of the merged chain.
+   */
+  template <class Compare>
+  static Node *mergeChains(Node *pA, Node *pB, Compare &comp);
+
+  /**
+   * Private helper for sort and merge; rebuild the pPrev pointers and
+   * pTail from the pNext chain starting at pHead.
+   */
+  void relinkPrev();
+
+  /**
+   * Private helper for the internal traversals; call visit on each node
+   * from pFirst on until it returns false. The node two ahead is
+   * prefetched before each visit, so its load overlaps the visit and
+   * the next step; pNext is read before the visit, so visit may free
+   * the node.
+   *
+   * \param pFirst First node to visit, or 0.
+   *
+   * \param visit Function called as visit(node), returning false to
+   * stop.
+   *
+   * \return Node visit returned false for, or 0 if it never did.
+   */
+  template <class Visit> static Node *walk(Node *pFirst, Visit visit);
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Definition of npos, for uses that need its address.
+ */
+template <class T, class Check, class Alloc>
+const std::size_t DLL<T, Check, Alloc>::npos;
+
+/*
+ * Implementation of the Iterator dereferencing operator.
+ */
+template <class T, class Check, class Alloc>
+template <class U>
+U &DLL<T, Check, Alloc>::BasicIterator<U>::operator*() const {
+  Check::require(pCurr != 0, "Dereferencing null Iterator in "
+                 "DLL::Iterator::operator*()");
+
+  return pCurr->data;
+}
+
+/*
+ * Implementation of assignment operator.
+ */
+template <class T, class Check, class Alloc>
+DLL<T, Check, Alloc> &
+DLL<T, Check, Alloc>::operator=(const DLL<T, Check, Alloc> &list) {
+  copy(list);
+
+  return *this;
+}
+
+/*
+ * Copy constructor implementation.
+ */
+template <class T, class Check, class Alloc>
+DLL<T, Check, Alloc>::DLL(const DLL<T, Check, Alloc> &list)
+    : alloc(list.alloc), pHead(0), pTail(0), n(0u), pReclaimer(0) {
+  copy(list);
+}
+
+/*
+ * Implementation of the Iterator increment operator.
+ */
+template <class T, class Check, class Alloc>
+template <class U>
+typename DLL<T, Check, Alloc>::template BasicIterator<U> &
+DLL<T, Check, Alloc>::BasicIterator<U>::operator++() {
+  Check::require(pCurr != 0, "Iterating past end of list in "
+                 "DLL::Iterator::operator++()");
+
+  pCurr = pCurr->pNext;
+
+  return *this;
+}
+
+/*
+ * Implementation of the Iterator decrement operator; the end iterator
+ * moves to the last element.
+ */
+template <class T, class Check, class Alloc>
+template <class U>
+typename DLL<T, Check, Alloc>::template BasicIterator<U> &
+DLL<T, Check, Alloc>::BasicIterator<U>::operator--() {
+  Node *pPrev = pCurr == 0 ? (pList == 0 ? 0 : pList->pTail) : pCurr->pPrev;
+
+  Check::require(pPrev != 0, "Iterating before start of list in "
+                 "DLL::Iterator::operator--()");
+
+  pCurr = pPrev;
+
+  return *this;
+}
+
+/*
+ * Implementation of the DLL addFirst method.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::addFirst(const T &d) {
+  Node *pN = newNode(d, 0, pHead);
+
+  if (pHead == 0) {
+    // empty list case
+    pHead = pTail = pN;
+  } else {
+    // non-empty list case
+    pHead = pN;
+    pHead->pNext->pPrev = pHead;
+  }
+
+  n++;
+}
+
+/*
+ * Implementation of the DLL addLast method.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::addLast(const T &d) {
+  Node *pN = newNode(d, pTail, 0);
+
+  if (pHead == 0) {
+    // empty list case
+    pHead = pTail = pN;
+  } else {
+    // non-empty list case
+    pTail = pN;
+    pTail->pPrev->pNext = pTail;
+  }
+
+  n++;
+}
+
+/*
+ * Implementation of the accumulate method.
+ */
+template <class T, class Check, class Alloc>
+template <class V, class Op>
+V DLL<T, Check, Alloc>::accumulate(V init, Op op) const {
+  walk(pHead, [&init, &op](Node *pN) {
+    init = op(init, static_cast<const T &>(pN->data));
+    return true;
+  });
+  return init;
+}
+
+/*
+ * Implementation of the DLL clear method. With a reclaimer, a large
+ * list's chain is detached and freed by its thread, with a copy of the
+ * allocator.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::clear() {
+  if (pReclaimer != 0 && n >= pReclaimer->minNodes() && n != 0u) {
+    Node *pFront = pHead, *pBack = pTail;
+    std::size_t count = n;
+    NodeAlloc a(alloc);
+    pReclaimer->retire([pFront, pBack, count, a]() mutable {
+      freeChain(a, pFront, pBack, count);
+    });
+  } else {
+    freeChain(alloc, pHead, pTail, n);
+  }
+
+  pHead = pTail = 0;
+  n = 0u;
+}
+
+/*
+ * Search for an element in the list.
+ */
+template <class T, class Check, class Alloc>
+std::size_t DLL<T, Check, Alloc>::contains(const T &d) const {
+  Node *pFront = pHead, *pBack = pTail;
+  std::size_t i = 0u, j = n, found = npos;
+
+  // search from both ends at once, for two independent chains of loads;
+  // a match from the front is the first, one from the back is kept
+  // until the two meet in case an earlier one turns up
+  while (i < j) {
+    if (pFront->data == d) {
+      return i;
+    }
+    if (++i == j) {
+      break;
+    }
+    if (pBack->data == d) {
+      found = j - 1u;
+    }
+    j--;
+    pFront = pFront->pNext;
+    pBack = pBack->pPrev;
+  }
+
+  return found;
+}
+
+/*
+ * Copy helper method implementation. Existing nodes are reused by
+ * assigning to their data; only the shortfall is allocated, as one
+ * chain linked in at the end, and only the surplus is freed. If
+ * copying an element throws, the chain is freed and this list keeps
+ * its nodes, some possibly already overwritten.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::copy(const DLL<T, Check, Alloc> &list) {
+  if (&list == this) {
+    return;
+  }
+
+  // find where the elements with no node to reuse begin
+  Node *pSrc = list.pHead;
+  for (std::size_t i = 0u; i < n && pSrc != 0; i++) {
+    pSrc = pSrc->pNext;
+  }
+
+  Node *pFirst = 0, *pLast = 0;
+  Node *pDst = pHead, *pKeep = 0;
+  try {
+    // build the shortfall chain
+    for (; pSrc != 0; pSrc = pSrc->pNext) {
+      Node *pN = newNode(pSrc->data, pLast, 0);
+      if (pLast == 0) {
+        pFirst = pN;
+      } else {
+        pLast->pNext = pN;
+      }
+      pLast = pN;
+    }
+
+    // overwrite the nodes we keep
+    for (pSrc = list.pHead; pDst != 0 && pSrc != 0; pSrc = pSrc->pNext) {
+      pDst->data = pSrc->data;
+      pKeep = pDst;
+      pDst = pDst->pNext;
+    }
+  } catch (...) {
+    while (pFirst != 0) {
+      Node *pNext = pFirst->pNext;
+      deleteNode(pFirst);
+      pFirst = pNext;
+    }
+    throw;
+  }
+
+  // free the surplus, from pDst on
+  while (pDst != 0) {
+    Node *pNext = pDst->pNext;
+    deleteNode(pDst);
+    pDst = pNext;
+  }
+
+  // link in the shortfall after the last kept node
+  if (pKeep == 0) {
+    pHead = pFirst;
+  } else {
+    pKeep->pNext = pFirst;
+  }
+  if (pFirst != 0) {
+    pFirst->pPrev = pKeep;
+    pTail = pLast;
+  } else {
+    pTail = pKeep;
+  }
+  n = list.n;
+}
+
+/*
+ * Implementation of the findIf method.
+ */
+template <class T, class Check, class Alloc>
+template <class Pred>
+typename DLL<T, Check, Alloc>::Iterator
+DLL<T, Check, Alloc>::findIf(Pred pred) {
+  Node *pFound = walk(pHead, [&pred](Node *pN) { return !pred(pN->data); });
+  return Iterator(this, pFound);
+}
+
+/*
+ * Implementation of the const findIf method.
+ */
+template <class T, class Check, class Alloc>
+template <class Pred>
+typename DLL<T, Check, Alloc>::ConstIterator
+DLL<T, Check, Alloc>::findIf(Pred pred) const {
+  Node *pFound = walk(pHead, [&pred](Node *pN) {
+    return !pred(static_cast<const T &>(pN->data));
+  });
+  return ConstIterator(this, pFound);
+}
+
+/*
+ * Implementation of the forEach method.
+ */
+template <class T, class Check, class Alloc>
+template <class Fn>
+void DLL<T, Check, Alloc>::forEach(Fn fn) {
+  walk(pHead, [&fn](Node *pN) {
+    fn(pN->data);
+    return true;
+  });
+}
+
+/*
+ * Implementation of the const forEach method.
+ */
+template <class T, class Check, class Alloc>
+template <class Fn>
+void DLL<T, Check, Alloc>::forEach(Fn fn) const {
+  walk(pHead, [&fn](Node *pN) {
+    fn(static_cast<const T &>(pN->data));
+    return true;
+  });
+}
+
+/*
+ * Get specified element from the list.
+ */
+template <class T, class Check, class Alloc>
+T &DLL<T, Check, Alloc>::get(std::size_t idx) const {
+  Check::require(idx < n, "Index beyond end of list in DLL::get()");
+
+  Node *pCurr = pHead;
+  for (std::size_t i = 0u; i < idx; i++) {
+    pCurr = pCurr->pNext;
+  }
+
+  return pCurr->data;
+}
+
+/*
+ * Get the first element in the list.
+ */
+template <class T, class Check, class Alloc>
+T &DLL<T, Check, Alloc>::getFirst() const {
+  Check::require(n != 0u, "Empty list in DLL::getFirst()");
+
+  return pHead->data;
+}
+
+/*
+ * Get the last element in the list.
+ */
+template <class T, class Check, class Alloc>
+T &DLL<T, Check, Alloc>::getLast() const {
+  Check::require(n != 0u, "Empty list in DLL::getLast()");
+
+  return pTail->data;
+}
+
+/*
+ * Merge another sorted list into this one.
+ */
+template <class T, class Check, class Alloc>
+template <class Compare>
+void DLL<T, Check, Alloc>::merge(DLL<T, Check, Alloc> &list, Compare comp) {
+  if (&list == this || list.pHead == 0) {
+    return;
+  }
+
+  pHead = mergeChains(pHead, list.pHead, comp);
+  n += list.n;
+  relinkPrev();
+
+  list.pHead = list.pTail = 0;
+  list.n = 0u;
+}
+
+/*
+ * Stably merge two null-terminated chains; on ties the node from the
+ * first chain goes first.
+ */
+template <class T, class Check, class Alloc>
+template <class Compare>
+typename DLL<T, Check, Alloc>::Node *
+DLL<T, Check, Alloc>::mergeChains(Node *pA, Node *pB, Compare &comp) {
+  Node *pFirst = 0;
+  Node **ppLink = &pFirst;
+
+  while (pA != 0 && pB != 0) {
+    if (comp(pB->data, pA->data)) {
+      *ppLink = pB;
+      pB = pB->pNext;
+    } else {
+      *ppLink = pA;
+      pA = pA->pNext;
+    }
+    ppLink = &(*ppLink)->pNext;
+  }
+
+  // one chain is exhausted; append the rest of the other, without
+  // walking it, since callers rebuild pTail with relinkPrev()
+  *ppLink = pA != 0 ? pA : pB;
+
+  return pFirst;
+}
+
+/*
+ * Rebuild backward links after relinking the forward chain.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::relinkPrev() {
+  Node *pPrevNode = 0;
+
+  for (Node *pCurr = pHead; pCurr != 0; pCurr = pCurr->pNext) {
+    pCurr->pPrev = pPrevNode;
+    pPrevNode = pCurr;
+  }
+
+  pTail = pPrevNode;
+}
+
+/*
+ * Remove specified element.
+ */
+template <class T, class Check, class Alloc>
+T DLL<T, Check, Alloc>::remove(std::size_t idx) {
+  Check::require(idx < n, "Remove past list bounds in DLL::remove()");
+
+  if (idx == 0u) {
+    return removeFirst();
+  } else if (idx == (n - 1u)) {
+    return removeLast();
+  } else {
+    Node *pCurr = pHead;
+    for (std::size_t i = 0u; i < idx; i++) {
+      pCurr = pCurr->pNext;
+    }
+    T d = pCurr->data;
+
+    pCurr->pPrev->pNext = pCurr->pNext;
+    pCurr->pNext->pPrev = pCurr->pPrev;
+    n--;
+
+    deleteNode(pCurr);
+
+    return d;
+  }
+}
+
+/*
+ * Remove first element from list.
+ */
+template <class T, class Check, class Alloc>
+T DLL<T, Check, Alloc>::removeFirst() {
+  Check::require(n != 0u, "Empty list in DLL::removeFirst()");
+  n--;
+  T d = pHead->data;
+  Node *pT = pHead;
+
+  pHead = pHead->pNext;
+  if (pHead != 0) {
+    pHead->pPrev = 0;
+  }
+
+  if (n == 0) {
+    pHead = pTail = 0;
+  }
+
+  deleteNode(pT);
+
+  return d;
+}
+
+/*
+ * Remove last element from list.
+ */
+template <class T, class Check, class Alloc>
+T DLL<T, Check, Alloc>::removeLast() {
+  Check::require(n != 0u, "Empty list in DLL::removeLast()");
+  n--;
+  Node *pT = pTail;
+  T d = pTail->data;
+
+  pTail = pTail->pPrev;
+  if (pTail != 0) {
+    pTail->pNext = 0;
+  }
+
+  if (n == 0) {
+    pHead = pTail = 0;
+  }
+
+  deleteNode(pT);
+
+  return d;
+}
+
+/*
+ * Change element at a specified index.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::set(std::size_t idx, const T &d) {
+  Check::require(idx < n, "Access past end of list in DLL::set()");
+
+  Node *pCurr = pHead;
+  for (std::size_t i = 0u; i < idx; i++) {
+    pCurr = pCurr->pNext;
+  }
+
+  pCurr->data = d;
+}
+
+/*
+ * Change element at the head of the list.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::setFirst(const T &d) {
+  Check::require(pHead != 0, "Set into front of empty list in DLL::setFirst()");
+
+  pHead->data = d;
+}
+
+/*
+ * Change element at the tail of the list.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::setLast(const T &d) {
+  Check::require(pTail != 0, "Set into end of empty list in DLL::setLast()");
+
+  pTail->data = d;
+}
+
+/*
+ * Cut the next run off the front of a chain. Ascending runs include
+ * equal elements; strictly descending runs are reversed, which cannot
+ * reorder equal elements since there are none in such a run.
+ */
+template <class T, class Check, class Alloc>
+template <class Compare>
+typename DLL<T, Check, Alloc>::Node *
+DLL<T, Check, Alloc>::takeRun(Node *&pRest, Compare &comp) {
+  Node *pFirst = pRest;
+  Node *pCurr = pFirst;
+
+  if (pCurr->pNext != 0 && comp(pCurr->pNext->data, pCurr->data)) {
+    // descending: reverse nodes onto the front as we go
+    pRest = pCurr->pNext;
+    pFirst->pNext = 0;
+    while (pRest != 0 && comp(pRest->data, pFirst->data)) {
+      Node *pNextRest = pRest->pNext;
+      pRest->pNext = pFirst;
+      pFirst = pRest;
+      pRest = pNextRest;
+    }
+    return pFirst;
+  }
+
+  while (pCurr->pNext != 0 && !comp(pCurr->pNext->data, pCurr->data)) {
+    pCurr = pCurr->pNext;
+  }
+  pRest = pCurr->pNext;
+  pCurr->pNext = 0;
+
+  return pFirst;
+}
+
+/*
+ * Natural merge sort. Runs are cut from the front of the list in order
+ * and merged into bins like carries in a binary counter, so bins[i]
+ * holds about 2^i runs and small merges happen while their nodes are
+ * still in cache. Bins with lower indices hold later elements, which
+ * is why each merge puts the bin's chain first. Only pNext is
+ * maintained during the sort; pPrev is rebuilt at the end.
+ */
+template <class T, class Check, class Alloc>
+template <class Compare> void DLL<T, Check, Alloc>::sort(Compare comp) {
+  if (n < 2u) {
+    return;
+  }
+
+  // enough bins for 2^64 runs, so the sort never allocates
+  Node *bins[64] = {0};
+  unsigned used = 0u;
+  Node *pRest = pHead;
+
+  while (pRest != 0) {
+    Node *pCarry = takeRun(pRest, comp);
+
+    unsigned i = 0u;
+    for (; i < used && bins[i] != 0; i++) {
+      pCarry = mergeChains(bins[i], pCarry, comp);
+      bins[i] = 0;
+    }
+    bins[i] = pCarry;
+    if (i == used) {
+      used++;
+    }
+  }
+
+  Node *pResult = 0;
+  for (unsigned i = 0u; i < used; i++) {
+    if (bins[i] != 0) {
+      pResult = pResult == 0 ? bins[i] : mergeChains(bins[i], pResult, comp);
+    }
+  }
+
+  pHead = pResult;
+  relinkPrev();
+}
+
+/*
+ * Move all of another list's nodes onto the end of this one.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::splice(DLL<T, Check, Alloc> &list) {
+  if (&list == this || list.pHead == 0) {
+    return;
+  }
+
+  if (pHead == 0) {
+    pHead = list.pHead;
+  } else {
+    pTail->pNext = list.pHead;
+    list.pHead->pPrev = pTail;
+  }
+  pTail = list.pTail;
+  n += list.n;
+
+  list.pHead = list.pTail = 0;
+  list.n = 0u;
+}
+
+/*
+ * Move the tail of this list, from idx on, into another list. The cut
+ * point is found by walking from whichever end is closer.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::splitOff(std::size_t idx,
+                                    DLL<T, Check, Alloc> &rest) {
+  Check::require(idx <= n, "Index beyond end of list in DLL::splitOff()");
+  if (&rest == this) {
+    throw std::invalid_argument("Splitting a list into itself in "
+                                "DLL::splitOff()");
+  }
+
+  rest.clear();
+  if (idx == n) {
+    return;
+  }
+
+  Node *pCut;
+  if (idx < n / 2u) {
+    pCut = pHead;
+    for (std::size_t i = 0u; i < idx; i++) {
+      pCut = pCut->pNext;
+    }
+  } else {
+    pCut = pTail;
+    for (std::size_t i = n - 1u; i > idx; i--) {
+      pCut = pCut->pPrev;
+    }
+  }
+
+  rest.pHead = pCut;
+  rest.pTail = pTail;
+  rest.n = n - idx;
+
+  pTail = pCut->pPrev;
+  if (pTail != 0) {
+    pTail->pNext = 0;
+  } else {
+    pHead = 0;
+  }
+  pCut->pPrev = 0;
+  n = idx;
+}
+
+/*
+ * Implementation of deleteNode.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::deleteNode(NodeAlloc &a, Node *pN) {
+  std::allocator_traits<NodeAlloc>::destroy(a, pN);
+  std::allocator_traits<NodeAlloc>::deallocate(a, pN, 1u);
+}
+
+/*
+ * Implementation of freeChain. On a large list out of cache, freeing
+ * from both ends about halves the time.
+ */
+template <class T, class Check, class Alloc>
+void DLL<T, Check, Alloc>::freeChain(NodeAlloc &a, Node *pFront,
+                                     Node *pBack, std::size_t count) {
+  for (std::size_t i = 0u; i < count / 2u; i++) {
+    Node *pF = pFront->pNext, *pB = pBack->pPrev;
+    deleteNode(a, pFront);
+    deleteNode(a, pBack);
+    pFront = pF;
+    pBack = pB;
+  }
+  if (count % 2u != 0u) {
+    deleteNode(a, pFront);
+  }
+}
+
+/*
+ * Implementation of newNode; the memory is freed again if the element
+ * copy throws.
+ */
+template <class T, class Check, class Alloc>
+typename DLL<T, Check, Alloc>::Node *
+DLL<T, Check, Alloc>::newNode(const T &d, Node *pP, Node *pN) {
+  Node *pNew = std::allocator_traits<NodeAlloc>::allocate(alloc, 1u);
+  try {
+    std::allocator_traits<NodeAlloc>::construct(alloc, pNew, d, pP, pN);
+  } catch (...) {
+    std::allocator_traits<NodeAlloc>::deallocate(alloc, pNew, 1u);
+    throw;
+  }
+  return pNew;
+}
+
+/*
+ * Implementation of walk. Only the node after next is prefetched: a
+ * list can't be read further ahead without waiting on the loads the
+ * prefetch is meant to hide.
+ */
+template <class T, class Check, class Alloc>
+template <class Visit>
+typename DLL<T, Check, Alloc>::Node *
+DLL<T, Check, Alloc>::walk(Node *pFirst, Visit visit) {
+  Node *pCurr = pFirst;
+
+  while (pCurr != 0) {
+    Node *pNext = pCurr->pNext;
+#if defined(__GNUC__)
+    if (pNext != 0) {
+      __builtin_prefetch(pNext->pNext);
+    }
+#endif
+    if (!visit(pCurr)) {
+      return pCurr;
+    }
+    pCurr = pNext;
+  }
+
+  return 0;
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a memory arena for list nodes. Memory is reserved
+ * from the system in large regions, aligned to 2 MiB, and on Linux the
+ * kernel is asked to back them with transparent huge pages, so a
+ * traversal of tens of millions of nodes touches far fewer TLB
+ * entries. Where mmap or madvise is unavailable the arena falls back to
+ * mmap without huge pages, or to operator new, and still works.
+ *
+ * Blocks are carved from the current region in order; freed blocks go
+ * on a free list for their size, rounded up to 16 bytes, and are reused
+ * first. Blocks larger than maxBlock are not reused until the arena is
+ * destroyed. Memory returns to the system only when the arena is
+ * destroyed, so every list using it must be destroyed first.
+ *
+ * An arena is not thread-safe; give each thread its own.
+ *
+ * Use it through ArenaAllocator, e.g.,
+ *
+ *   HugePageArena arena;
+ *   DLL<int, Checked, ArenaAllocator<int> > list(
+ *       (ArenaAllocator<int>(arena)));
+ */
+class HugePageArena {
+public:
+  /** Alignment, and rounding, of every block. */
+  static const std::size_t blockAlign = 16u;
+
+  /** Largest block size with a free list. */
+  static const std::size_t maxBlock = 256u;
+
+  /** Huge page size regions are aligned to. */
+  static const std::size_t hugePageSize = std::size_t(2u) << 20;
+
+  /**
+   * Constructor. No memory is reserved until the first allocation.
+   *
+   * \param regionBytes Size of each region reserved from the system,
+   * rounded up to a multiple of hugePageSize.
+   *
+   * \param hugePages Whether to ask for transparent huge pages; false
+   * gives an arena with ordinary pages, for comparison.
+   */
+  explicit HugePageArena(std::size_t regionBytes = std::size_t(64u) << 20,
+                         bool hugePages = true);
+
+  /**
+   * Destructor. Return every region to the system.
+   */
+  ~HugePageArena();
+
+  /**
+   * Allocate a block.
+   *
+   * \param bytes Size of the block.
+   *
+   * \param align Alignment needed; at most blockAlign.
+   *
+   * \return Pointer to the block.
+   *
+   * \throws std::bad_alloc if no memory is available or align is too
+   * large.
+   */
+  void *allocate(std::size_t bytes, std::size_t align);
+
+  /**
+   * Free a block for reuse.
+   *
+   * \param p Block from allocate().
+   *
+   * \param bytes Size passed to allocate().
+   */
+  void deallocate(void *p, std::size_t bytes);
+
+  /**
+   * Get the number of bytes reserved from the system.
+   *
+   * \return Total size of the regions.
+   */
+  std::size_t bytesReserved() const { return reserved; }
+
+  /**
+   * Get the number of regions the kernel accepted the huge page request
+   * for. The kernel may still back parts of them with ordinary pages.
+   *
+   * \return Number of regions advised to use huge pages.
+   */
+  std::size_t hugePageRegions() const { return advised; }
+
+  /**
+   * Get the number of regions reserved from the system.
+   *
+   * \return Number of regions.
+   */
+  std::size_t regions() const { return regionBases.size(); }
+
+private:
+  HugePageArena(const HugePageArena &);
+  HugePageArena &operator=(const HugePageArena &);
+
+  /** Size of each region. */
+  std::size_t regionBytes;
+
+  /** Whether to ask for huge pages. */
+  bool hugePages;
+
+  /** Next free byte in the current region. */
+  char *pNext;
+
+  /** End of the current region. */
+  char *pEnd;
+
+  /** Heads of the free lists, by size / blockAlign - 1. */
+  void *freeLists[maxBlock / blockAlign];
+
+  /** Start of each region, as returned by the system. */
+  std::vector<void *> regionBases;
+
+  /** Length of each region mapping; 0 if it came from operator new. */
+  std::vector<std::size_t> regionLengths;
+
+  /** Total bytes reserved. */
+  std::size_t reserved;
+
+  /** Number of regions madvise accepted. */
+  std::size_t advised;
+
+  /**
+   * Reserve a new region of at least minBytes and make it current.
+   */
+  void newRegion(std::size_t minBytes);
+
+  /**
+   * Round a block size up to a non-zero multiple of blockAlign.
+   */
+  static std::size_t roundUp(std::size_t bytes) {
+    return bytes == 0u ? blockAlign
+                       : (bytes + blockAlign - 1u) / blockAlign * blockAlign;
+  }
+};
+
+/**
+ * Minimal standard allocator handing out memory from a HugePageArena,
+ * for use as the Alloc parameter of DLL. Copies, including rebound
+ * ones, share the arena and compare equal.
+ */
+template <class T> class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  /**
+   * Constructor.
+   *
+   * \param arena Arena to allocate from; it must outlive the allocator.
+   */
+  explicit ArenaAllocator(HugePageArena &arena) : pArena(&arena) {}
+
+  /** Converting constructor for rebinding. */
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : pArena(other.arena()) {}
+
+  /** Allocate room for n objects of type T. */
+  T *allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(pArena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  /** Free room for n objects of type T. */
+  void deallocate(T *p, std::size_t n) {
+    pArena->deallocate(p, n * sizeof(T));
+  }
+
+  /** Get the arena. */
+  HugePageArena *arena() const { return pArena; }
+
+  template <class U> bool operator==(const ArenaAllocator<U> &other) const {
+    return pArena == other.arena();
+  }
+
+  template <class U> bool operator!=(const ArenaAllocator<U> &other) const {
+    return pArena != other.arena();
+  }
+
+private:
+  /** Arena the memory comes from. */
+  HugePageArena *pArena;
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the constructor.
+ */
+inline HugePageArena::HugePageArena(std::size_t regionBytes, bool hugePages)
+    : regionBytes((regionBytes + hugePageSize - 1u) / hugePageSize *
+                  hugePageSize),
+      hugePages(hugePages), pNext(0), pEnd(0), reserved(0u), advised(0u) {
+  if (this->regionBytes == 0u) {
+    this->regionBytes = hugePageSize;
+  }
+  for (std::size_t i = 0u; i < maxBlock / blockAlign; i++) {
+    freeLists[i] = 0;
+  }
+}
+
+/*
+ * Implementation of the destructor.
+ */
+inline HugePageArena::~HugePageArena() {
+  for (std::size_t i = 0u; i < regionBases.size(); i++) {
+#if defined(__unix__) || defined(__APPLE__)
+    if (regionLengths[i] != 0u) {
+      munmap(regionBases[i], regionLengths[i]);
+      continue;
+    }
+#endif
+    ::operator delete(regionBases[i]);
+  }
+}
+
+/*
+ * Implementation of allocate: pop the free list for the size if it has
+ * a block, otherwise carve one from the current region.
+ */
+inline void *HugePageArena::allocate(std::size_t bytes, std::size_t align) {
+  const std::size_t maxBytes =
+      std::numeric_limits<std::size_t>::max() - hugePageSize;
+  if (align > blockAlign || bytes > maxBytes) {
+    throw std::bad_alloc();
+  }
+
+  std::size_t size = roundUp(bytes);
+
+  if (size <= maxBlock) {
+    void *&head = freeLists[size / blockAlign - 1u];
+    if (head != 0) {
+      void *p = head;
+      head = *static_cast<void **>(p);
+      return p;
+    }
+  }
+
+  if (std::size_t(pEnd - pNext) < size) {
+    newRegion(size);
+  }
+
+  void *p = pNext;
+  pNext += size;
+  return p;
+}
+
+/*
+ * Implementation of deallocate.
+ */
+inline void HugePageArena::deallocate(void *p, std::size_t bytes) {
+  std::size_t size = roundUp(bytes);
+
+  if (p != 0 && size <= maxBlock) {
+    void *&head = freeLists[size / blockAlign - 1u];
+    *static_cast<void **>(p) = head;
+    head = p;
+  }
+}
+
+/*
+ * Implementation of newRegion. On POSIX systems the region is mapped
+ * with an extra huge page of slack so that it can start on a huge page
+ * boundary, which the kernel needs before it will use huge pages.
+ */
+inline void HugePageArena::newRegion(std::size_t minBytes) {
+  std::size_t bytes = regionBytes;
+  if (bytes < minBytes) {
+    bytes = (minBytes + hugePageSize - 1u) / hugePageSize * hugePageSize;
+  }
+
+  char *pStart = 0;
+  std::size_t length = 0u;
+  regionBases.reserve(regionBases.size() + 1u);
+  regionLengths.reserve(regionLengths.size() + 1u);
+
+#if defined(__unix__) || defined(__APPLE__)
+  length = bytes + hugePageSize;
+  void *pMap = mmap(0, length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (pMap == MAP_FAILED) {
+    length = 0u;
+  } else {
+    regionBases.push_back(pMap);
+    regionLengths.push_back(length);
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(pMap);
+    std::uintptr_t aligned =
+        (base + hugePageSize - 1u) / hugePageSize * hugePageSize;
+    pStart = reinterpret_cast<char *>(aligned);
+#ifdef MADV_HUGEPAGE
+    if (hugePages && madvise(pStart, bytes, MADV_HUGEPAGE) == 0) {
+      advised++;
+    }
+#endif
+  }
+#endif
+
+  if (length == 0u) {
+    // no mmap, or it failed: plain memory, still in large regions
+    pStart = static_cast<char *>(::operator new(bytes));
+    regionBases.push_back(pStart);
+    regionLengths.push_back(0u);
+  }
+
+  reserved += bytes;
+  pNext = pStart;
+  pEnd = pStart + bytes;
+}
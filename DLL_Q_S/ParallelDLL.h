@@ -0,0 +1,268 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "DLL.h"
+#include "ThreadPool.h"
+
+//-----------------------------------------------------------
+// helper functions
+//-----------------------------------------------------------
+
+/**
+ * Work out how a list of a given length splits into roughly equal
+ * segments, without walking it. Lists too short to be worth splitting
+ * get a single segment.
+ *
+ * \param n Number of elements in the list.
+ *
+ * \param nSegments Maximum number of segments wanted.
+ *
+ * \param lengths Set to the number of elements in each segment.
+ */
+inline void segmentLengths(std::size_t n, unsigned nSegments,
+                           std::vector<std::size_t> &lengths) {
+  // below this many elements per segment, threading costs more than it
+  // saves
+  const std::size_t minSegment = 4096u;
+
+  if (nSegments > n / minSegment) {
+    nSegments = n / minSegment;
+  }
+  if (nSegments == 0u) {
+    nSegments = 1u;
+  }
+
+  lengths.clear();
+  for (unsigned s = 0u; s < nSegments; s++) {
+    // spread the remainder over the first segments
+    lengths.push_back(n / nSegments + (s < n % nSegments ? 1u : 0u));
+  }
+}
+
+/**
+ * Split a list into roughly equal segments in one pass, recording an
+ * iterator to the start of each; see segmentLengths().
+ *
+ * \param list List to split.
+ *
+ * \param nSegments Maximum number of segments wanted.
+ *
+ * \param starts Set to the first iterator of each segment; const lists
+ * give ConstIterators.
+ *
+ * \param lengths Set to the number of elements in each segment.
+ */
+template <class List, class It>
+void splitSegments(List &list, unsigned nSegments, std::vector<It> &starts,
+                   std::vector<std::size_t> &lengths) {
+  segmentLengths(list.size(), nSegments, lengths);
+  starts.clear();
+
+  It it = list.begin();
+  for (size_t s = 0u; s < lengths.size(); s++) {
+    starts.push_back(it);
+    if (s + 1u < lengths.size()) {
+      for (std::size_t i = 0u; i < lengths[s]; i++) {
+        ++it;
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------
+// parallel algorithms
+//-----------------------------------------------------------
+
+/**
+ * Call fn on every element of a list, in parallel. fn may be called on
+ * different elements concurrently, in any order.
+ *
+ * \param pool Thread pool to run on.
+ *
+ * \param list List to process.
+ *
+ * \param fn Function taking a T &.
+ */
+template <class T, class Fn>
+void parallelForEach(ThreadPool &pool, DLL<T> &list, Fn fn) {
+  std::vector<typename DLL<T>::Iterator> starts;
+  std::vector<std::size_t> lengths;
+  splitSegments(list, pool.size(), starts, lengths);
+
+  for (size_t s = 0u; s < starts.size(); s++) {
+    typename DLL<T>::Iterator first = starts[s];
+    std::size_t length = lengths[s];
+    pool.submit([first, length, &fn]() {
+      typename DLL<T>::Iterator it = first;
+      for (std::size_t i = 0u; i < length; i++, ++it) {
+        fn(*it);
+      }
+    });
+  }
+  pool.wait();
+}
+
+/**
+ * Replace every element of a list with fn applied to it, in parallel.
+ *
+ * \param pool Thread pool to run on.
+ *
+ * \param list List to transform.
+ *
+ * \param fn Function taking a const T & and returning a T.
+ */
+template <class T, class Fn>
+void parallelTransform(ThreadPool &pool, DLL<T> &list, Fn fn) {
+  parallelForEach(pool, list, [&fn](T &a) { a = fn(a); });
+}
+
+/**
+ * Combine every element of a list with a binary operation, in parallel.
+ * Each segment is reduced left to right, and the segment results are
+ * then combined left to right onto init, so the result is
+ * init op (a0 op a1 op ... op an-1) for any associative op, even one
+ * that is not commutative, and is the same on every run. Floating-point
+ * addition is not exactly associative, so sums of doubles may differ in
+ * the last bits from a serial loop, though not from run to run with the
+ * same pool size.
+ *
+ * \param pool Thread pool to run on.
+ *
+ * \param list List to reduce.
+ *
+ * \param init Initial value.
+ *
+ * \param op Associative function taking two T values and returning a T.
+ *
+ * \return The reduced value; init for an empty list.
+ */
+template <class T, class Op>
+T parallelReduce(ThreadPool &pool, const DLL<T> &list, T init, Op op) {
+  if (list.isEmpty()) {
+    return init;
+  }
+
+  std::vector<typename DLL<T>::ConstIterator> starts;
+  std::vector<std::size_t> lengths;
+  splitSegments(list, pool.size(), starts, lengths);
+  std::vector<T> partial(starts.size());
+
+  for (size_t s = 0u; s < starts.size(); s++) {
+    typename DLL<T>::ConstIterator first = starts[s];
+    std::size_t length = lengths[s];
+    T *pResult = &partial[s];
+    pool.submit([first, length, pResult, &op]() {
+      typename DLL<T>::ConstIterator it = first;
+      T acc = *it;
+      for (std::size_t i = 1u; i < length; i++) {
+        ++it;
+        acc = op(acc, *it);
+      }
+      *pResult = acc;
+    });
+  }
+  pool.wait();
+
+  T result = partial[0];
+  for (size_t s = 1u; s < partial.size(); s++) {
+    result = op(result, partial[s]);
+  }
+
+  return op(init, result);
+}
+
+/**
+ * Count the elements of a list satisfying a predicate, in parallel.
+ *
+ * \param pool Thread pool to run on.
+ *
+ * \param list List to search.
+ *
+ * \param pred Function taking a const T & and returning bool.
+ *
+ * \return Number of elements for which pred is true.
+ */
+template <class T, class Pred>
+std::size_t parallelCountIf(ThreadPool &pool, const DLL<T> &list, Pred pred) {
+  std::vector<typename DLL<T>::ConstIterator> starts;
+  std::vector<std::size_t> lengths;
+  splitSegments(list, pool.size(), starts, lengths);
+  std::vector<std::size_t> counts(starts.size(), 0u);
+
+  for (size_t s = 0u; s < starts.size(); s++) {
+    typename DLL<T>::ConstIterator first = starts[s];
+    std::size_t length = lengths[s];
+    std::size_t *pCount = &counts[s];
+    pool.submit([first, length, pCount, &pred]() {
+      typename DLL<T>::ConstIterator it = first;
+      std::size_t count = 0u;
+      for (std::size_t i = 0u; i < length; i++, ++it) {
+        if (pred(*it)) {
+          count++;
+        }
+      }
+      *pCount = count;
+    });
+  }
+  pool.wait();
+
+  std::size_t total = 0u;
+  for (size_t s = 0u; s < counts.size(); s++) {
+    total += counts[s];
+  }
+
+  return total;
+}
+
+/**
+ * Sort a list in parallel: split it into roughly equal sublists, sort
+ * each with DLL::sort on the pool, then merge neighbouring sublists in
+ * rounds, also on the pool. Nodes are relinked, never copied, and
+ * merges always take the left sublist first on ties, so the sort is
+ * stable like DLL::sort.
+ *
+ * \param pool Thread pool to run on.
+ *
+ * \param list List to sort.
+ *
+ * \param comp Strict weak ordering to sort by; must not throw.
+ */
+template <class T, class Compare>
+void parallelSort(ThreadPool &pool, DLL<T> &list, Compare comp) {
+  // only the lengths are needed, so the list isn't walked for starts
+  std::vector<std::size_t> lengths;
+  segmentLengths(list.size(), pool.size(), lengths);
+
+  if (lengths.size() < 2u) {
+    list.sort(comp);
+    return;
+  }
+
+  // cut the list into sublists, last first, so each cut is at the end
+  std::vector<DLL<T> > parts(lengths.size());
+  std::size_t idx = list.size();
+  for (size_t s = lengths.size() - 1u; s > 0u; s--) {
+    idx -= lengths[s];
+    list.splitOff(idx, parts[s]);
+  }
+  parts[0].splice(list);
+
+  for (size_t s = 0u; s < parts.size(); s++) {
+    DLL<T> *pPart = &parts[s];
+    pool.submit([pPart, &comp]() { pPart->sort(comp); });
+  }
+  pool.wait();
+
+  // merge neighbours in rounds: 0+1, 2+3, ..., then 0+2, 4+6, ...
+  for (size_t step = 1u; step < parts.size(); step *= 2u) {
+    for (size_t s = 0u; s + step < parts.size(); s += 2u * step) {
+      DLL<T> *pLeft = &parts[s];
+      DLL<T> *pRight = &parts[s + step];
+      pool.submit([pLeft, pRight, &comp]() { pLeft->merge(*pRight, comp); });
+    }
+    pool.wait();
+  }
+
+  list.splice(parts[0]);
+}
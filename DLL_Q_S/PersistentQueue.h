@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+#include "CheckPolicy.h"
+#include "PersistentStack.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a persistent (immutable) queue, built from two
+ * PersistentStacks: elements are dequeued from the top of front and
+ * enqueued on top of rear, and when front runs out, rear is reversed
+ * into it. Copying a queue is O(1), since both stacks share their
+ * nodes, so snapshots of a busy work queue are cheap to take and keep.
+ *
+ * The Queue API is provided: enqueue() and dequeue() move this object
+ * to a new version and leave every copy unchanged; enqueued() and
+ * dequeued() return the new version instead. Each element is reversed
+ * at most once per version that dequeues it, so a queue used like an
+ * ordinary Queue costs amortized O(1) per operation; repeatedly
+ * dequeuing from one old snapshot whose front is about to run out
+ * repeats the reversal.
+ *
+ * \tparam T Element type.
+ *
+ * \tparam Check Checking policy from CheckPolicy.h; Checked throws
+ * std::out_of_range when the queue is empty.
+ */
+template <class T, class Check = Checked> class PersistentQueue {
+public:
+  /**
+   * Default constructor. Make a new, empty queue.
+   */
+  PersistentQueue() {}
+
+  /**
+   * Remove all the elements from this queue.
+   */
+  void clear() {
+    front.clear();
+    rear.clear();
+  }
+
+  /**
+   * Remove the first element from the queue; copies of the queue keep
+   * it.
+   *
+   * \return First element from the queue.
+   */
+  T dequeue();
+
+  /**
+   * Get the version of this queue without its first element.
+   *
+   * \return New queue sharing nodes with this one.
+   */
+  PersistentQueue<T, Check> dequeued() const;
+
+  /**
+   * Add an element to the end of the queue; copies of the queue don't
+   * see it.
+   *
+   * \param a Element to add to the queue.
+   */
+  void enqueue(const T &a);
+
+  /**
+   * Get the version of this queue with an element added to the end.
+   *
+   * \param a Element to add.
+   *
+   * \return New queue sharing every node of this one.
+   */
+  PersistentQueue<T, Check> enqueued(const T &a) const;
+
+  /**
+   * Determine if this queue is empty.
+   *
+   * \return True if the queue is empty, false otherwise.
+   */
+  bool isEmpty() const { return front.isEmpty(); }
+
+  /**
+   * Get a reference to the first element, without removing it.
+   *
+   * \return Reference to the element dequeue() would return.
+   */
+  const T &peek() const;
+
+  /**
+   * Get the number of elements in the queue.
+   *
+   * \return Number of elements in the queue.
+   */
+  std::size_t size() const { return front.size() + rear.size(); }
+
+  /**
+   * Override of the stream insertion operator for PersistentQueue
+   * objects, printing from first to last like Queue.
+   *
+   * \param out ostream object to output to, e.g., cout
+   *
+   * \param queue PersistentQueue to output
+   *
+   * \return the out ostream object
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const PersistentQueue<T, Check> &queue) {
+    std::vector<T> elements;
+    elements.reserve(queue.size());
+    for (Half s = queue.front; !s.isEmpty(); s.pop()) {
+      elements.push_back(s.peek());
+    }
+    std::size_t nFront = elements.size();
+    for (Half s = queue.rear; !s.isEmpty(); s.pop()) {
+      elements.push_back(s.peek());
+    }
+
+    out << "[";
+
+    for (std::size_t i = 0u; i < elements.size(); i++) {
+      // the rear stack holds the last elements newest first
+      std::size_t j = i < nFront ? i : elements.size() - 1u - (i - nFront);
+      out << elements[j];
+
+      if (i + 1u < elements.size()) {
+        out << ", ";
+      }
+    }
+
+    out << "]";
+
+    return out;
+  }
+
+private:
+  /** Stack type used for both halves; the queue makes the checks. */
+  typedef PersistentStack<T, Unchecked> Half;
+
+  /** First elements, first on top; empty only if the queue is. */
+  Half front;
+
+  /** Last elements, last on top. */
+  Half rear;
+
+  /**
+   * Restore the invariant that front is empty only when the queue is,
+   * by reversing rear into front.
+   */
+  void normalize();
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the dequeue method.
+ */
+template <class T, class Check> T PersistentQueue<T, Check>::dequeue() {
+  Check::require(!front.isEmpty(),
+                 "Empty queue in PersistentQueue::dequeue()");
+  T a = front.pop();
+  normalize();
+  return a;
+}
+
+/*
+ * Implementation of the dequeued method.
+ */
+template <class T, class Check>
+PersistentQueue<T, Check> PersistentQueue<T, Check>::dequeued() const {
+  Check::require(!front.isEmpty(),
+                 "Empty queue in PersistentQueue::dequeued()");
+  PersistentQueue<T, Check> queue;
+  queue.front = front.popped();
+  queue.rear = rear;
+  queue.normalize();
+  return queue;
+}
+
+/*
+ * Implementation of the enqueue method.
+ */
+template <class T, class Check>
+void PersistentQueue<T, Check>::enqueue(const T &a) {
+  if (front.isEmpty()) {
+    front.push(a);
+  } else {
+    rear.push(a);
+  }
+}
+
+/*
+ * Implementation of the enqueued method.
+ */
+template <class T, class Check>
+PersistentQueue<T, Check>
+PersistentQueue<T, Check>::enqueued(const T &a) const {
+  PersistentQueue<T, Check> queue(*this);
+  queue.enqueue(a);
+  return queue;
+}
+
+/*
+ * Implementation of normalize.
+ */
+template <class T, class Check> void PersistentQueue<T, Check>::normalize() {
+  if (front.isEmpty()) {
+    while (!rear.isEmpty()) {
+      front.push(rear.pop());
+    }
+  }
+}
+
+/*
+ * Implementation of the peek method.
+ */
+template <class T, class Check>
+const T &PersistentQueue<T, Check>::peek() const {
+  Check::require(!front.isEmpty(), "Empty queue in PersistentQueue::peek()");
+  return front.peek();
+}
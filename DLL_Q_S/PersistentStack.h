@@ -0,0 +1,304 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include "CheckPolicy.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a persistent (immutable) stack: a singly-linked
+ * list of reference-counted nodes whose tails are shared between
+ * versions. Copying a stack, or taking a new version with pushed() or
+ * popped(), is O(1) and never copies elements, and a set of versions
+ * uses memory only for the nodes they do not share. This suits
+ * evaluators that snapshot their stack for backtracking.
+ *
+ * The Stack API is also provided: push() and pop() move this object to
+ * a new version and leave every copy unchanged. Since nodes are shared,
+ * peek() returns a const reference.
+ *
+ * Reference counts are atomic, so different threads may copy, modify
+ * and destroy stacks sharing nodes; a single stack object is not
+ * thread-safe.
+ *
+ * \tparam T Element type.
+ *
+ * \tparam Check Checking policy from CheckPolicy.h; Checked throws
+ * std::out_of_range when the stack is empty.
+ */
+template <class T, class Check = Checked> class PersistentStack {
+private:
+  //-------------------------------------------------------
+  // inner class definition
+  //-------------------------------------------------------
+
+  /**
+   * Private nested class representing immutable, shared nodes.
+   */
+  class Node {
+  public:
+    Node(const T &d, Node *pN) : data(d), pNext(pN), refs(1u) {}
+
+    /** Type T payload of the Node. */
+    T data;
+
+    /** Pointer to the node below; one reference to it is owned. */
+    Node *pNext;
+
+    /** Number of stacks and nodes pointing at this node. */
+    std::atomic<unsigned> refs;
+  };
+
+public:
+  /**
+   * Default constructor. Make a new, empty stack.
+   */
+  PersistentStack() : pTop(0), n(0u) {}
+
+  /**
+   * Copy constructor. Make this stack share another's nodes, in O(1).
+   *
+   * \param stack Stack to copy from.
+   */
+  PersistentStack(const PersistentStack<T, Check> &stack)
+      : pTop(acquire(stack.pTop)), n(stack.n) {}
+
+  /**
+   * Destructor. Release the nodes no other stack shares.
+   */
+  ~PersistentStack() { release(pTop); }
+
+  /**
+   * Remove all elements from this stack.
+   */
+  void clear();
+
+  /**
+   * Determine if the stack is empty.
+   *
+   * \return True if the stack is empty, false if it has elements.
+   */
+  bool isEmpty() const { return pTop == 0; }
+
+  /**
+   * Get a reference to the top element on the stack, without removing
+   * it.
+   *
+   * \return Reference to the element at the top of the stack.
+   */
+  const T &peek() const;
+
+  /**
+   * Pop the top element from the stack; copies of the stack keep it.
+   *
+   * \return Element of type T that was at the top of the stack.
+   */
+  T pop();
+
+  /**
+   * Get the version of this stack without its top element.
+   *
+   * \return New stack sharing all but the top node with this one.
+   */
+  PersistentStack<T, Check> popped() const;
+
+  /**
+   * Push a new item onto the stack; copies of the stack don't see it.
+   *
+   * \param a Element of type T to push onto the stack.
+   */
+  void push(const T &a);
+
+  /**
+   * Get the version of this stack with an element pushed on top.
+   *
+   * \param a Element of type T to push.
+   *
+   * \return New stack sharing every node of this one.
+   */
+  PersistentStack<T, Check> pushed(const T &a) const;
+
+  /**
+   * Get the number of elements in the stack.
+   *
+   * \return Number of elements in the stack.
+   */
+  std::size_t size() const { return n; }
+
+  /**
+   * Overloaded assignment operator; O(1), and safe for self-assignment.
+   *
+   * \param stack Stack to share nodes with.
+   *
+   * \return Reference to this stack, for chaining.
+   */
+  PersistentStack<T, Check> &operator=(const PersistentStack<T, Check> &stack);
+
+  /**
+   * Override of the stream insertion operator for PersistentStack
+   * objects, printing from the top down like Stack.
+   *
+   * \param out ostream object to output to, e.g., cout
+   *
+   * \param stack PersistentStack to output
+   *
+   * \return the out ostream object
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const PersistentStack<T, Check> &stack) {
+    out << "[";
+
+    for (Node *pCurr = stack.pTop; pCurr != 0; pCurr = pCurr->pNext) {
+      out << pCurr->data;
+
+      if (pCurr->pNext != 0) {
+        out << ", ";
+      }
+    }
+
+    out << "]";
+
+    return out;
+  }
+
+private:
+  /** Top node, or 0 if the stack is empty; one reference is owned. */
+  Node *pTop;
+
+  /** Number of elements in the stack. */
+  std::size_t n;
+
+  /**
+   * Private constructor taking over a reference to pT.
+   */
+  PersistentStack(Node *pT, std::size_t n) : pTop(pT), n(n) {}
+
+  /**
+   * Add a reference to a node.
+   *
+   * \param pN Node to reference, or 0.
+   *
+   * \return pN.
+   */
+  static Node *acquire(Node *pN);
+
+  /**
+   * Drop a reference to a node, deleting it and then each node below it
+   * whose last reference goes with it. Iterative, so that releasing a
+   * deep stack cannot overflow the call stack.
+   *
+   * \param pN Node to release, or 0.
+   */
+  static void release(Node *pN);
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of acquire.
+ */
+template <class T, class Check>
+typename PersistentStack<T, Check>::Node *
+PersistentStack<T, Check>::acquire(Node *pN) {
+  if (pN != 0) {
+    pN->refs.fetch_add(1u, std::memory_order_relaxed);
+  }
+  return pN;
+}
+
+/*
+ * Implementation of the clear method.
+ */
+template <class T, class Check> void PersistentStack<T, Check>::clear() {
+  release(pTop);
+  pTop = 0;
+  n = 0u;
+}
+
+/*
+ * Implementation of the peek method.
+ */
+template <class T, class Check>
+const T &PersistentStack<T, Check>::peek() const {
+  Check::require(pTop != 0, "Empty stack in PersistentStack::peek()");
+  return pTop->data;
+}
+
+/*
+ * Implementation of the pop method. A top node no other stack shares
+ * is ours alone, so its element can be moved out rather than copied.
+ */
+template <class T, class Check> T PersistentStack<T, Check>::pop() {
+  Check::require(pTop != 0, "Empty stack in PersistentStack::pop()");
+
+  Node *pOld = pTop;
+  bool unique = pOld->refs.load(std::memory_order_acquire) == 1u;
+  T d = unique ? std::move(pOld->data) : pOld->data;
+
+  pTop = acquire(pOld->pNext);
+  n--;
+  release(pOld);
+
+  return d;
+}
+
+/*
+ * Implementation of the popped method.
+ */
+template <class T, class Check>
+PersistentStack<T, Check> PersistentStack<T, Check>::popped() const {
+  Check::require(pTop != 0, "Empty stack in PersistentStack::popped()");
+  return PersistentStack<T, Check>(acquire(pTop->pNext), n - 1u);
+}
+
+/*
+ * Implementation of the push method; the new node takes over this
+ * stack's reference to the old top.
+ */
+template <class T, class Check>
+void PersistentStack<T, Check>::push(const T &a) {
+  pTop = new Node(a, pTop);
+  n++;
+}
+
+/*
+ * Implementation of the pushed method.
+ */
+template <class T, class Check>
+PersistentStack<T, Check>
+PersistentStack<T, Check>::pushed(const T &a) const {
+  return PersistentStack<T, Check>(new Node(a, acquire(pTop)), n + 1u);
+}
+
+/*
+ * Implementation of release.
+ */
+template <class T, class Check>
+void PersistentStack<T, Check>::release(Node *pN) {
+  while (pN != 0 && pN->refs.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+    Node *pNext = pN->pNext;
+    delete pN;
+    pN = pNext;
+  }
+}
+
+/*
+ * Overloaded assignment operator implementation; acquiring before
+ * releasing makes self-assignment safe.
+ */
+template <class T, class Check>
+PersistentStack<T, Check> &
+PersistentStack<T, Check>::operator=(const PersistentStack<T, Check> &stack) {
+  Node *pNew = acquire(stack.pTop);
+  release(pTop);
+  pTop = pNew;
+  n = stack.n;
+  return *this;
+}
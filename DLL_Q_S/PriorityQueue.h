@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a templated priority queue, using a d-ary heap
+ * stored contiguously in a vector as the underlying data structure.
+ *
+ * As with std::priority_queue, dequeue() returns the greatest element
+ * according to Compare, so the default std::less<T> gives a max-queue
+ * and std::greater<T> a min-queue. enqueue() and dequeue() are
+ * O(log n); a larger D makes the heap shallower, which speeds up
+ * enqueue and costs D - 1 more comparisons per level in dequeue.
+ *
+ * \tparam T Element type.
+ *
+ * \tparam Compare Strict weak ordering on T.
+ *
+ * \tparam D Number of children per heap node, at least 2.
+ */
+template <class T, class Compare = std::less<T>, unsigned D = 2>
+class PriorityQueue {
+  static_assert(D >= 2u, "PriorityQueue needs two or more children per node");
+
+public:
+  /**
+   * Default constructor. Make a new, empty priority queue.
+   *
+   * \param comp Comparison object used to order elements.
+   */
+  explicit PriorityQueue(const Compare &comp = Compare()) : comp(comp) {}
+
+  /**
+   * Range constructor. Make a priority queue holding the elements in
+   * [first, last), building the heap bottom-up in O(n) time.
+   *
+   * \param first Iterator to the first element to add.
+   *
+   * \param last Iterator one past the last element to add.
+   *
+   * \param comp Comparison object used to order elements.
+   */
+  template <class InputIt>
+  PriorityQueue(InputIt first, InputIt last, const Compare &comp = Compare());
+
+  /**
+   * Remove all the elements from this priority queue.
+   */
+  void clear() { heap.clear(); }
+
+  /**
+   * Remove the greatest element from the priority queue.
+   *
+   * \return Greatest element in the priority queue.
+   */
+  T dequeue();
+
+  /**
+   * Add an element to the priority queue.
+   *
+   * \param a Element to add to the priority queue.
+   */
+  void enqueue(const T &a);
+
+  /**
+   * Determine if this priority queue is empty.
+   *
+   * \return True if the priority queue is empty, false otherwise.
+   */
+  bool isEmpty() const { return heap.empty(); }
+
+  /**
+   * Get a reference to the greatest element, without removing it.
+   *
+   * \return Reference to the element dequeue() would return.
+   */
+  const T &peek() const;
+
+  /**
+   * Make room for at least n elements, so that enqueueing up to n
+   * elements does not reallocate.
+   *
+   * \param n Number of elements to reserve space for.
+   */
+  void reserve(std::size_t n) { heap.reserve(n); }
+
+  /**
+   * Get the number of elements in the priority queue.
+   *
+   * \return Number of elements in the priority queue.
+   */
+  std::size_t size() const { return heap.size(); }
+
+  /**
+   * Override of the stream insertion operator for PriorityQueue
+   * objects. Elements are printed in the order dequeue() would return
+   * them.
+   *
+   * \param out ostream object to output to, e.g., cout
+   *
+   * \param pq PriorityQueue to output
+   *
+   * \return the out ostream object
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const PriorityQueue<T, Compare, D> &pq) {
+    std::vector<T> sorted(pq.heap);
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&pq](const T &a, const T &b) { return pq.comp(b, a); });
+
+    out << "[";
+
+    for (typename std::vector<T>::size_type i = 0u; i < sorted.size(); i++) {
+      out << sorted[i];
+
+      if (i + 1u < sorted.size()) {
+        out << ", ";
+      }
+    }
+
+    out << "]";
+
+    return out;
+  }
+
+private:
+  /** Heap-ordered elements; the children of heap[i] are
+   * heap[D * i + 1] through heap[D * i + D]. */
+  std::vector<T> heap;
+
+  /** Comparison object ordering the elements. */
+  Compare comp;
+
+  /**
+   * Move the element at index i up until its parent is not less than it.
+   *
+   * \param i Index of the element to sift up.
+   */
+  void siftUp(std::size_t i);
+
+  /**
+   * Move the element at index i down until no child is greater than it.
+   *
+   * \param i Index of the element to sift down.
+   */
+  void siftDown(std::size_t i);
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the range constructor, using Floyd's bottom-up
+ * heap construction.
+ */
+template <class T, class Compare, unsigned D>
+template <class InputIt>
+PriorityQueue<T, Compare, D>::PriorityQueue(InputIt first, InputIt last,
+                                            const Compare &comp)
+    : heap(first, last), comp(comp) {
+  if (heap.size() > 1u) {
+    for (std::size_t i = (heap.size() - 2u) / D + 1u; i > 0u; i--) {
+      siftDown(i - 1u);
+    }
+  }
+}
+
+/*
+ * Implementation of the dequeue method.
+ */
+template <class T, class Compare, unsigned D>
+T PriorityQueue<T, Compare, D>::dequeue() {
+  if (heap.empty()) {
+    throw std::out_of_range("Empty queue in PriorityQueue::dequeue()");
+  }
+
+  T top = std::move(heap.front());
+
+  // with one element, front and back are the same, and moving it onto
+  // itself would be a self-move assignment
+  if (heap.size() > 1u) {
+    heap.front() = std::move(heap.back());
+    heap.pop_back();
+    siftDown(0u);
+  } else {
+    heap.pop_back();
+  }
+
+  return top;
+}
+
+/*
+ * Implementation of the enqueue method.
+ */
+template <class T, class Compare, unsigned D>
+void PriorityQueue<T, Compare, D>::enqueue(const T &a) {
+  heap.push_back(a);
+  siftUp(heap.size() - 1u);
+}
+
+/*
+ * Implementation of the peek method.
+ */
+template <class T, class Compare, unsigned D>
+const T &PriorityQueue<T, Compare, D>::peek() const {
+  if (heap.empty()) {
+    throw std::out_of_range("Empty queue in PriorityQueue::peek()");
+  }
+  return heap.front();
+}
+
+/*
+ * Implementation of sift up; the moving element is held aside and
+ * written once, rather than swapped at every level.
+ */
+template <class T, class Compare, unsigned D>
+void PriorityQueue<T, Compare, D>::siftUp(std::size_t i) {
+  T a = std::move(heap[i]);
+
+  while (i > 0u) {
+    std::size_t parent = (i - 1u) / D;
+    if (!comp(heap[parent], a)) {
+      break;
+    }
+    heap[i] = std::move(heap[parent]);
+    i = parent;
+  }
+
+  heap[i] = std::move(a);
+}
+
+/*
+ * Implementation of sift down, again holding the moving element aside.
+ */
+template <class T, class Compare, unsigned D>
+void PriorityQueue<T, Compare, D>::siftDown(std::size_t i) {
+  std::size_t n = heap.size();
+  T a = std::move(heap[i]);
+
+  while (true) {
+    std::size_t first = D * i + 1u;
+    if (first >= n) {
+      break;
+    }
+
+    // find the greatest child
+    std::size_t last = std::min(first + D, n);
+    std::size_t best = first;
+    for (std::size_t c = first + 1u; c < last; c++) {
+      if (comp(heap[best], heap[c])) {
+        best = c;
+      }
+    }
+
+    if (!comp(a, heap[best])) {
+      break;
+    }
+    heap[i] = std::move(heap[best]);
+    i = best;
+  }
+
+  heap[i] = std::move(a);
+}
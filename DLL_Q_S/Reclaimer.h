@@ -0,0 +1,208 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "BoundedQueue.h"
+#include "Retirer.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a background thread that frees memory for other
+ * threads. A DLL given a Reclaimer with setReclaimer() detaches its
+ * node chain in O(1) when it is cleared or destroyed and hands the
+ * freeing to this thread, so that dropping a list of tens of millions
+ * of elements doesn't stall the thread that dropped it.
+ *
+ * The backlog of chains waiting to be freed is bounded: when it is
+ * full, the caller frees its chain itself, so memory held by detached
+ * lists can't grow without limit. Chains shorter than minNodes are
+ * always freed by the caller, since handing them off costs more than
+ * freeing them.
+ *
+ * The destructor drains the backlog, so a Reclaimer must outlive every
+ * list using it. Lists whose allocator is not thread-safe, such as an
+ * ArenaAllocator, must not use one.
+ */
+class Reclaimer : public Retirer {
+public:
+  /**
+   * Constructor. Start the background thread.
+   *
+   * \param backlog Maximum number of chains waiting to be freed; at
+   * least 1.
+   *
+   * \param minNodes Smallest chain handed to the background thread.
+   */
+  explicit Reclaimer(unsigned backlog = 16u, std::size_t minNodes = 4096u);
+
+  /**
+   * Destructor. Free every chain in the backlog and stop the thread.
+   */
+  ~Reclaimer();
+
+  /**
+   * Wait until every chain handed off so far has been freed, e.g.,
+   * before measuring memory or at shutdown.
+   */
+  void drain();
+
+  /**
+   * Get the number of chains freed by the background thread.
+   *
+   * \return Number of chains freed in the background so far.
+   */
+  std::size_t freedInBackground() const;
+
+  /**
+   * Get the number of chains freed by the caller because the backlog
+   * was full.
+   *
+   * \return Number of chains freed by the caller so far.
+   */
+  std::size_t freedInline() const;
+
+  /**
+   * Get the smallest chain handed to the background thread.
+   *
+   * \return Minimum number of nodes.
+   */
+  std::size_t minNodes() const override { return minChain; }
+
+  /**
+   * Hand a job freeing a detached chain to the background thread, or
+   * run it here if the backlog is full.
+   *
+   * \param job Function freeing the chain; it must not throw.
+   */
+  void retire(const std::function<void()> &job) override;
+
+private:
+  // the reclaimer owns a thread, so it cannot be copied
+  Reclaimer(const Reclaimer &);
+  Reclaimer &operator=(const Reclaimer &);
+
+  /** Smallest chain handed to the background thread. */
+  std::size_t minChain;
+
+  /** Jobs waiting for the background thread. */
+  BoundedQueue<std::function<void()> > jobs;
+
+  /** Number of jobs handed off and not yet finished. */
+  std::size_t pending;
+
+  /** Number of jobs the background thread has finished. */
+  std::size_t background;
+
+  /** Number of jobs run by the caller. */
+  std::size_t inlined;
+
+  /** Lock protecting the counters. */
+  mutable std::mutex mutex;
+
+  /** Signaled when pending drops to zero. */
+  std::condition_variable idle;
+
+  /** Thread running the jobs; started last. */
+  std::thread worker;
+
+  /**
+   * Body of the background thread: run jobs until the queue is closed
+   * and empty.
+   */
+  void run();
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the constructor.
+ */
+inline Reclaimer::Reclaimer(unsigned backlog, std::size_t minNodes)
+    : minChain(minNodes), jobs(backlog), pending(0u), background(0u),
+      inlined(0u), worker(&Reclaimer::run, this) {}
+
+/*
+ * Implementation of the destructor.
+ */
+inline Reclaimer::~Reclaimer() {
+  jobs.close();
+  worker.join();
+}
+
+/*
+ * Implementation of the drain method.
+ */
+inline void Reclaimer::drain() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (pending != 0u) {
+    idle.wait(lock);
+  }
+}
+
+/*
+ * Implementation of the freedInBackground method.
+ */
+inline std::size_t Reclaimer::freedInBackground() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return background;
+}
+
+/*
+ * Implementation of the freedInline method.
+ */
+inline std::size_t Reclaimer::freedInline() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return inlined;
+}
+
+/*
+ * Implementation of the retire method. pending is raised before the
+ * job is queued, so drain() can't miss a job the worker is running.
+ */
+inline void Reclaimer::retire(const std::function<void()> &job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending++;
+  }
+
+  if (!jobs.tryEnqueue(job)) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending--;
+      inlined++;
+    }
+    // the backlog is full, or the reclaimer is shutting down
+    job();
+    idle.notify_all();
+  }
+}
+
+/*
+ * Implementation of run.
+ */
+inline void Reclaimer::run() {
+  std::function<void()> job;
+
+  while (jobs.dequeue(job)) {
+    job();
+    job = std::function<void()>();
+
+    bool wake;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      background++;
+      wake = --pending == 0u;
+    }
+    if (wake) {
+      idle.notify_all();
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Interface for something that frees detached node chains for a list,
+ * e.g., a Reclaimer, which does so on a background thread. DLL only
+ * needs this interface, so lists that never use one don't pull in
+ * threads and queues.
+ */
+class Retirer {
+public:
+  /**
+   * Destructor.
+   */
+  virtual ~Retirer() {}
+
+  /**
+   * Get the smallest chain worth handing off; shorter ones are freed by
+   * the list itself.
+   *
+   * \return Minimum number of nodes.
+   */
+  virtual std::size_t minNodes() const = 0;
+
+  /**
+   * Take a job freeing a detached chain, and run it some time before
+   * the retirer is destroyed.
+   *
+   * \param job Function freeing the chain; it must not throw.
+   */
+  virtual void retire(const std::function<void()> &job) = 0;
+};
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Queue.h"
+
+class Scheduler;
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Return type of a fire-and-forget coroutine run by a Scheduler, e.g.,
+ *
+ *   Task producer(Channel<int> &ch) { co_await ch.enqueue(1); }
+ *   scheduler.spawn(producer(ch));
+ *
+ * A Task does nothing until it is spawned, and its frame is destroyed
+ * as soon as it finishes.
+ */
+class Task {
+public:
+  /**
+   * Promise type required by the coroutine machinery.
+   */
+  struct promise_type {
+    /** Scheduler running the task, set by Scheduler::spawn. */
+    Scheduler *pScheduler = nullptr;
+
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    /** Don't start until spawned. */
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    /** Tell the scheduler, then let the frame be destroyed. */
+    std::suspend_never final_suspend() noexcept;
+
+    void return_void() {}
+
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  /**
+   * Move constructor; a Task can only be spawned once.
+   *
+   * \param other Task to take the coroutine from.
+   */
+  Task(Task &&other) noexcept : handle(other.handle) { other.handle = {}; }
+
+  /**
+   * Destructor. Destroys the coroutine if it was never spawned.
+   */
+  ~Task() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  // make us a friend of the scheduler, which takes the coroutine over
+  friend class Scheduler;
+
+private:
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+
+  /** Private constructor used by promise_type. */
+  explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+  /** The coroutine, or null once it has been spawned. */
+  std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * Abstract base class for coroutine schedulers. A scheduler keeps a
+ * queue of coroutines that are ready to run; channels hand it the
+ * coroutines they wake up.
+ */
+class Scheduler {
+public:
+  Scheduler() : live(0u) {}
+
+  virtual ~Scheduler() {}
+
+  /**
+   * Start running a task.
+   *
+   * \param task Task to run; the scheduler takes it over.
+   */
+  void spawn(Task task);
+
+  /**
+   * Queue a suspended coroutine to be resumed.
+   *
+   * \param h Coroutine to resume.
+   */
+  virtual void schedule(std::coroutine_handle<> h) = 0;
+
+  /**
+   * Get the number of spawned tasks that have not finished.
+   *
+   * \return Number of live tasks.
+   */
+  unsigned liveTasks() const { return live.load(); }
+
+  // tasks report that they have finished
+  friend struct Task::promise_type;
+
+protected:
+  /**
+   * Called as each task finishes.
+   */
+  virtual void taskFinished() { live--; }
+
+  /** Number of spawned tasks that have not finished. */
+  std::atomic<unsigned> live;
+};
+
+/**
+ * Scheduler that runs every coroutine on the thread calling run(), so
+ * switching between coroutines costs a queue operation and a resume.
+ */
+class SingleThreadScheduler : public Scheduler {
+public:
+  /**
+   * Queue a suspended coroutine to be resumed.
+   *
+   * \param h Coroutine to resume.
+   */
+  void schedule(std::coroutine_handle<> h) override { ready.enqueue(h); }
+
+  /**
+   * Resume ready coroutines until none are left.
+   *
+   * \return Number of tasks still alive, i.e., blocked on channels that
+   * nothing will ever wake; 0 if every task ran to completion.
+   */
+  unsigned run();
+
+private:
+  /** Coroutines waiting to be resumed. */
+  Queue<std::coroutine_handle<> > ready;
+};
+
+/**
+ * Scheduler that resumes coroutines on a pool of worker threads. Any
+ * coroutine may be resumed on any worker, so the channels they share
+ * must be thread-safe, as Channel is.
+ */
+class ThreadPoolScheduler : public Scheduler {
+public:
+  /**
+   * Constructor.
+   *
+   * \param nThreads Number of worker threads; 0 means one per hardware
+   * thread.
+   */
+  explicit ThreadPoolScheduler(unsigned nThreads = 0u);
+
+  /**
+   * Queue a suspended coroutine to be resumed.
+   *
+   * \param h Coroutine to resume.
+   */
+  void schedule(std::coroutine_handle<> h) override;
+
+  /**
+   * Run the workers until every spawned task has finished. Tasks that
+   * never finish make run() wait forever.
+   */
+  void run();
+
+protected:
+  void taskFinished() override;
+
+private:
+  /** Number of worker threads. */
+  unsigned nThreads;
+
+  /** Coroutines waiting to be resumed. */
+  Queue<std::coroutine_handle<> > ready;
+
+  /** Lock protecting ready and done. */
+  std::mutex mutex;
+
+  /** Signaled when a coroutine is queued or the last task finishes. */
+  std::condition_variable wake;
+
+  /** Set when the last task finishes, to stop the workers. */
+  bool done;
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Final suspend point of a task: report completion to the scheduler.
+ */
+inline std::suspend_never Task::promise_type::final_suspend() noexcept {
+  if (pScheduler != nullptr) {
+    pScheduler->taskFinished();
+  }
+  return {};
+}
+
+/*
+ * Implementation of spawn.
+ */
+inline void Scheduler::spawn(Task task) {
+  std::coroutine_handle<Task::promise_type> h = task.handle;
+  task.handle = {};
+
+  h.promise().pScheduler = this;
+  live++;
+  schedule(h);
+}
+
+/*
+ * Implementation of the single-threaded run loop.
+ */
+inline unsigned SingleThreadScheduler::run() {
+  while (!ready.isEmpty()) {
+    ready.dequeue().resume();
+  }
+
+  return live.load();
+}
+
+/*
+ * Implementation of the thread pool constructor.
+ */
+inline ThreadPoolScheduler::ThreadPoolScheduler(unsigned nThreads)
+    : nThreads(nThreads), done(false) {
+  if (this->nThreads == 0u) {
+    this->nThreads = std::thread::hardware_concurrency();
+  }
+  if (this->nThreads == 0u) {
+    this->nThreads = 1u;
+  }
+}
+
+/*
+ * Implementation of thread pool scheduling.
+ */
+inline void ThreadPoolScheduler::schedule(std::coroutine_handle<> h) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.enqueue(h);
+  }
+  wake.notify_one();
+}
+
+/*
+ * Implementation of thread pool task completion.
+ */
+inline void ThreadPoolScheduler::taskFinished() {
+  if (--live == 0u) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      done = true;
+    }
+    wake.notify_all();
+  }
+}
+
+/*
+ * Implementation of the thread pool run loop.
+ */
+inline void ThreadPoolScheduler::run() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = live.load() == 0u;
+  }
+
+  std::vector<std::thread> workers;
+  for (unsigned i = 0u; i < nThreads; i++) {
+    workers.emplace_back([this]() {
+      while (true) {
+        std::coroutine_handle<> h;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          while (ready.isEmpty() && !done) {
+            wake.wait(lock);
+          }
+          if (ready.isEmpty()) {
+            return;
+          }
+          h = ready.dequeue();
+        }
+        h.resume();
+      }
+    });
+  }
+
+  for (std::thread &t : workers) {
+    t.join();
+  }
+}
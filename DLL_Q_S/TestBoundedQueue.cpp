@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BoundedQueue.h"
+#include "TestCheck.h"
+
+/**
+ * Get this process's resident set size in KiB from /proc, or 0 where
+ * /proc is not available.
+ */
+long residentKiB() {
+  std::ifstream status("/proc/self/status");
+  std::string key;
+
+  while (status >> key) {
+    if (key == "VmRSS:") {
+      long kib;
+      status >> kib;
+      return kib;
+    }
+  }
+
+  return 0;
+}
+
+int main() {
+  using namespace std;
+
+  BoundedQueue<int> q1(4u);
+
+  for (int i = 0; i < 4; i++) {
+    q1.enqueue(i);
+  }
+
+  cout << q1 << " " << q1.size() << "/" << q1.capacity() << endl;
+
+  cout << "tryEnqueue on full queue: " << (q1.tryEnqueue(4) ? "ok" : "fails")
+       << endl;
+  cout << "enqueueFor on full queue: "
+       << (q1.enqueueFor(4, chrono::milliseconds(10)) ? "ok" : "times out")
+       << endl;
+
+  int a;
+  while (q1.tryDequeue(a)) {
+    cout << a << endl;
+  }
+
+  cout << "dequeueFor on empty queue: "
+       << (q1.dequeueFor(a, chrono::milliseconds(10)) ? "ok" : "times out")
+       << endl;
+
+  // a blocked consumer is released by close()
+  thread closer([&q1]() {
+    this_thread::sleep_for(chrono::milliseconds(20));
+    q1.close();
+  });
+  cout << "dequeue on closed queue: " << (q1.dequeue(a) ? "ok" : "fails")
+       << endl;
+  closer.join();
+  cout << "enqueue on closed queue: " << (q1.enqueue(1) ? "ok" : "fails")
+       << endl;
+
+  // batches keep FIFO order
+  BoundedQueue<int> q2(8u);
+  int items[20], got[20];
+  for (int i = 0; i < 20; i++) {
+    items[i] = i;
+  }
+  thread batchProducer([&]() { q2.enqueueBatch(items, 20u); });
+  unsigned total = 0u;
+  while (total < 20u) {
+    total += q2.dequeueBatch(got + total, 20u - total);
+  }
+  batchProducer.join();
+  bool inOrder = true;
+  for (int i = 0; i < 20; i++) {
+    inOrder = inOrder && got[i] == i;
+  }
+  check(inOrder, "batch of 20 through capacity 8 in order");
+  cout << "batch of 20 through capacity 8: " << (inOrder ? "in order" : "bad")
+       << endl;
+
+  // a fast producer against a slow consumer: the queue never holds more
+  // than its capacity, so memory stays bounded even though the producer
+  // makes far more data than that
+  const unsigned capacity = 64u, count = 20000u, payload = 64u * 1024u;
+  BoundedQueue<vector<char> > q3(capacity);
+  unsigned maxSize = 0u;
+  long startKiB = residentKiB(), maxKiB = startKiB;
+
+  thread producer([&]() {
+    for (unsigned i = 0u; i < count; i++) {
+      q3.enqueue(vector<char>(payload, static_cast<char>(i)));
+    }
+    q3.close();
+  });
+
+  vector<char> v;
+  unsigned received = 0u;
+  while (q3.dequeue(v)) {
+    check(v.size() == payload && v[0] == static_cast<char>(received),
+          "payload " + to_string(received));
+    received++;
+    if (received % 256u == 0u) {
+      maxSize = max(maxSize, q3.size());
+      maxKiB = max(maxKiB, residentKiB());
+      this_thread::sleep_for(chrono::microseconds(200));
+    }
+  }
+  producer.join();
+
+  long growthKiB = maxKiB - startKiB;
+  long producedKiB = static_cast<long>(count) * payload / 1024;
+  long boundKiB = 2L * capacity * payload / 1024 + 8192L;
+
+  cout << "received " << received << " of " << count << endl;
+  cout << "largest size seen " << maxSize << " of " << capacity << endl;
+  cout << "memory growth " << growthKiB << " KiB for " << producedKiB
+       << " KiB produced" << endl;
+
+  check(received == count, "every payload received");
+  check(maxSize <= capacity, "size bounded by capacity");
+  check(growthKiB <= boundKiB, "memory growth bounded");
+
+  return finishChecks();
+}
@@ -0,0 +1,120 @@
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include "Channel.h"
+#include "Scheduler.h"
+#include "TestCheck.h"
+
+/**
+ * Send 0 .. count - 1 down a channel, then close it.
+ */
+Task producer(Channel<int> &out, int count) {
+  for (int i = 0; i < count; i++) {
+    co_await out.enqueue(i);
+  }
+  out.close();
+}
+
+/**
+ * Pipeline stage: add one to every element until the input closes.
+ */
+Task incrementer(Channel<int> &in, Channel<int> &out) {
+  while (std::optional<int> a = co_await in.dequeue()) {
+    co_await out.enqueue(*a + 1);
+  }
+  out.close();
+}
+
+/**
+ * Print everything from a channel.
+ */
+Task printer(Channel<int> &in) {
+  while (std::optional<int> a = co_await in.dequeue()) {
+    std::cout << *a << " ";
+  }
+  std::cout << std::endl;
+}
+
+/**
+ * Add everything from a channel into a total.
+ */
+Task summer(Channel<int> &in, long &total) {
+  while (std::optional<int> a = co_await in.dequeue()) {
+    total += *a;
+  }
+}
+
+/**
+ * Try to send after the channel is closed.
+ */
+Task lateProducer(Channel<int> &out) {
+  bool ok = co_await out.enqueue(1);
+  std::cout << "enqueue on closed channel: " << (ok ? "ok" : "fails")
+            << std::endl;
+}
+
+int main() {
+  using namespace std;
+
+  // producer -> incrementer -> printer, with a small buffer
+  SingleThreadScheduler s1;
+  Channel<int> a(s1, 2u), b(s1, 2u);
+  s1.spawn(producer(a, 10));
+  s1.spawn(incrementer(a, b));
+  s1.spawn(printer(b));
+  unsigned live = s1.run();
+  cout << "live tasks after run: " << live << endl;
+  check(live == 0u, "pipeline finishes");
+
+  // capacity 0: every enqueue meets a dequeue
+  SingleThreadScheduler s2;
+  Channel<int> c(s2, 0u);
+  s2.spawn(producer(c, 5));
+  s2.spawn(printer(c));
+  s2.run();
+
+  s2.spawn(lateProducer(c));
+  s2.run();
+
+  // a consumer with no producer stays blocked, and run() reports it
+  SingleThreadScheduler s3;
+  Channel<int> d(s3, 1u);
+  s3.spawn(printer(d));
+  live = s3.run();
+  cout << "live tasks with an idle consumer: " << live << endl;
+  check(live == 1u, "idle consumer stays blocked");
+  d.close();
+  live = s3.run();
+  cout << "live tasks after close: " << live << endl;
+  check(live == 0u, "close releases the consumer");
+
+  // a long pipeline of stages on a thread pool
+  const int stages = 100, count = 10000;
+  ThreadPoolScheduler pool(4u);
+  Channel<int> *channels[stages + 1];
+  for (int i = 0; i <= stages; i++) {
+    channels[i] = new Channel<int>(pool, 4u);
+  }
+  long total = 0;
+  pool.spawn(producer(*channels[0], count));
+  for (int i = 0; i < stages; i++) {
+    pool.spawn(incrementer(*channels[i], *channels[i + 1]));
+  }
+  pool.spawn(summer(*channels[stages], total));
+  pool.run();
+
+  // every element went through 100 incrementers
+  long expected = 0;
+  for (int i = 0; i < count; i++) {
+    expected += i + stages;
+  }
+  cout << "thread pool pipeline total "
+       << (total == expected ? "matches" : "differs") << endl;
+  check(total == expected, "thread pool pipeline total");
+
+  for (int i = 0; i <= stages; i++) {
+    delete channels[i];
+  }
+
+  return finishChecks();
+}
@@ -1,92 +1,184 @@
-#include <cstdlib>
-#include <iostream>
-#include <string>
-#include "DLL.h"
-
-int main() {
-
-  using namespace std;
-
-  DLL<int> list;
-
-  cout << "DLL::<<" << endl;
-
-  for (int i = 0; i < 10; i++) {
-    list.addFirst(i);
-  }
-
-  for (int i = 5; i >= 1; i--) {
-    list.addLast(i);
-  }
-
-  cout << "DLL iterator" << endl;
-  for (DLL<int>::Iterator i = list.begin(); i != list.end(); ++i) {
-    cout << *i << " ";
-  }
-  cout << endl;
-
-  cout << list << endl;
-
-  cout << "List " << (list.isEmpty() ? "is" : "is not") << " empty" << endl;
-  cout << "List has " << list.size() << " elements" << endl;
-
-  cout << "First element: " << list.getFirst() << endl;
-  cout << "Last element: " << list.getLast() << endl;
-
-  cout << "Removing first element: " << list.removeFirst() << endl;
-  cout << list << endl;
-
-  cout << "Removing last element: " << list.removeLast() << endl;
-  cout << list << endl;
-
-  cout << "List " << (list.isEmpty() ? "is" : "is not") << " empty" << endl;
-  cout << "List has " << list.size() << " elements" << endl;
-
-  cout << "Accessing odd indices: " << endl;
-  for (unsigned i = 1; i < list.size(); i += 2) {
-    cout << list.get(i) << " ";
-  }
-
-  cout << endl;
-
-  cout << "Changing even indices: " << endl;
-  for (unsigned i = 0; i < list.size(); i += 2) {
-    list.set(i, -9);
-  }
-
-  cout << list << endl;
-
-  cout << "Index of 5: " << list.contains(5) << endl;
-  cout << "Index of 18: " << list.contains(18) << endl;
-
-  cout << "Copying list:" << endl;
-  DLL<int> list2(list);
-
-  cout << list2 << endl;
-
-  cout << "Assigning list:" << endl;
-  DLL<int> list3;
-  list3 = list;
-
-  cout << list3 << endl;
-
-  cout << "Removing at index 3: " << list.remove(3) << endl;
-  cout << list << endl;
-
-  cout << "Changing first element:" << endl;
-
-  list.setFirst(65);
-  cout << list << endl;
-
-  cout << "Changing last element:" << endl;
-
-  list.setLast(66);
-  cout << list << endl;
-
-  list.clear();
-
-  cout << "List " << (list.isEmpty() ? "is" : "is not") << " empty" << endl;
-  cout << "List has " << list.size() << " elements" << endl;
-
-  return EXIT_SUCCESS;
-}
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include "DLL.h"
+
+int main() {
+
+  using namespace std;
+
+  DLL<int> list;
+
+  cout << "DLL::<<" << endl;
+
+  for (int i = 0; i < 10; i++) {
+    list.addFirst(i);
+  }
+
+  for (int i = 5; i >= 1; i--) {
+    list.addLast(i);
+  }
+
+  cout << "DLL iterator" << endl;
+  for (DLL<int>::Iterator i = list.begin(); i != list.end(); ++i) {
+    cout << *i << " ";
+  }
+  cout << endl;
+
+  cout << list << endl;
+
+  cout << "DLL reverse iterator" << endl;
+  for (DLL<int>::reverse_iterator i = list.rbegin(); i != list.rend(); ++i) {
+    cout << *i << " ";
+  }
+  cout << endl;
+
+  cout << "DLL range-for over const list" << endl;
+  const DLL<int> &constList = list;
+  for (const int &d : constList) {
+    cout << d << " ";
+  }
+  cout << endl;
+
+  DLL<int>::Iterator last = list.end();
+  --last;
+  cout << "Last element via --end(): " << *last << endl;
+  cout << "begin() " << (list.begin() == list.cbegin() ? "==" : "!=")
+       << " cbegin()" << endl;
+  cout << "Count of 5 via std::count: "
+       << count(list.cbegin(), list.cend(), 5) << endl;
+  cout << "Max via std::max_element: "
+       << *max_element(constList.begin(), constList.end()) << endl;
+
+  cout << "Reversing with std::reverse:" << endl;
+  reverse(list.begin(), list.end());
+  cout << list << endl;
+  reverse(list.begin(), list.end());
+
+  cout << "List " << (list.isEmpty() ? "is" : "is not") << " empty" << endl;
+  cout << "List has " << list.size() << " elements" << endl;
+
+  cout << "First element: " << list.getFirst() << endl;
+  cout << "Last element: " << list.getLast() << endl;
+
+  cout << "Removing first element: " << list.removeFirst() << endl;
+  cout << list << endl;
+
+  cout << "Removing last element: " << list.removeLast() << endl;
+  cout << list << endl;
+
+  cout << "List " << (list.isEmpty() ? "is" : "is not") << " empty" << endl;
+  cout << "List has " << list.size() << " elements" << endl;
+
+  cout << "Accessing odd indices: " << endl;
+  for (size_t i = 1; i < list.size(); i += 2) {
+    cout << list.get(i) << " ";
+  }
+
+  cout << endl;
+
+  cout << "Changing even indices: " << endl;
+  for (size_t i = 0; i < list.size(); i += 2) {
+    list.set(i, -9);
+  }
+
+  cout << list << endl;
+
+  cout << "Index of 5: " << list.contains(5) << endl;
+  cout << "Index of 18: "
+       << (list.contains(18) == DLL<int>::npos ? "npos" : "found") << endl;
+
+  cout << "Copying list:" << endl;
+  DLL<int> list2(list);
+
+  cout << list2 << endl;
+
+  cout << "Assigning list:" << endl;
+  DLL<int> list3;
+  list3 = list;
+
+  cout << list3 << endl;
+
+  cout << "Assigning to a longer, a shorter and the same list:" << endl;
+  DLL<int> longer, shorter;
+  for (int i = 0; i < 20; i++) {
+    longer.addLast(100 + i);
+  }
+  shorter.addLast(7);
+  longer = list;
+  shorter = list;
+  list3 = list3;
+  cout << longer << " " << longer.size() << endl;
+  cout << shorter << " " << shorter.size() << endl;
+  cout << list3 << " " << list3.size() << endl;
+  shorter.addLast(99);
+  cout << "Last after append: " << shorter.getLast() << ", before: "
+       << *----shorter.end() << endl;
+
+  cout << "Removing at index 3: " << list.remove(3) << endl;
+  cout << list << endl;
+
+  cout << "Changing first element:" << endl;
+
+  list.setFirst(65);
+  cout << list << endl;
+
+  cout << "Changing last element:" << endl;
+
+  list.setLast(66);
+  cout << list << endl;
+
+  cout << "Sorting list:" << endl;
+
+  list.sort();
+  cout << list << endl;
+
+  cout << "Sorting list in descending order:" << endl;
+
+  list.sort(greater<int>());
+  cout << list << endl;
+
+  cout << "Splitting list at index 4:" << endl;
+
+  DLL<int> rest;
+  list.splitOff(4, rest);
+  cout << list << " " << rest << endl;
+
+  cout << "Merging sorted lists:" << endl;
+
+  DLL<int> evens, odds;
+  for (int i = 0; i < 10; i += 2) {
+    evens.addLast(i);
+    odds.addLast(i + 1);
+  }
+  evens.merge(odds);
+  cout << evens << " " << odds << endl;
+
+  cout << "Splicing lists:" << endl;
+
+  list.splice(rest);
+  cout << list << " " << rest << endl;
+
+  cout << "Internal traversal:" << endl;
+
+  list.forEach([](int &d) { d *= 10; });
+  int sum = list.accumulate(0, [](int acc, int d) { return acc + d; });
+  DLL<int>::Iterator big = list.findIf([](int d) { return d > 50; });
+  cout << list << " sum " << sum << ", first over 50 ";
+  if (big != list.end()) {
+    cout << *big;
+  } else {
+    cout << "none";
+  }
+  cout << ", contains 30 at " << list.contains(30) << endl;
+
+  list.clear();
+
+  cout << "List " << (list.isEmpty() ? "is" : "is not") << " empty" << endl;
+  cout << "List has " << list.size() << " elements" << endl;
+
+  return EXIT_SUCCESS;
+}
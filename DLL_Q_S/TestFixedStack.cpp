@@ -0,0 +1,73 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include "FixedStack.h"
+
+/**
+ * Push 0 .. count - 1 and return the sum of what pops back off; used
+ * to exercise FixedStack in a constant expression.
+ */
+constexpr int pushPopSum(int count) {
+  FixedStack<int, 16> stack;
+
+  for (int i = 0; i < count; i++) {
+    stack.push(i);
+  }
+
+  int sum = 0;
+  while (!stack.isEmpty()) {
+    sum += stack.pop();
+  }
+
+  return sum;
+}
+
+static_assert(pushPopSum(10) == 45, "FixedStack must work at compile time");
+static_assert(FixedStack<double, 4>().capacity() == 4u,
+              "FixedStack capacity is N");
+
+int main() {
+  using namespace std;
+
+  FixedStack<int, 10> stack;
+
+  for (int i = 0; i < 10; i++) {
+    stack.push(i);
+  }
+
+  cout << stack << " " << stack.size() << endl;
+
+  cout << "stack " << (stack.isFull() ? "is" : "is not") << " full" << endl;
+
+  try {
+    stack.push(10);
+  } catch (const std::out_of_range &oor) {
+    cout << oor.what() << endl;
+  }
+
+  FixedStack<int, 10> st1(stack);
+
+  cout << st1 << " " << st1.size() << endl;
+
+  stack.clear();
+
+  cout << stack << " " << stack.size() << endl;
+
+  cout << st1.peek() << endl;
+
+  try {
+    cout << stack.peek() << endl;
+  } catch (const std::out_of_range &oor) {
+    cout << oor.what() << endl;
+  }
+
+  try {
+    while (true) {
+      cout << st1.pop() << endl;
+    }
+  } catch (const std::out_of_range &oor) {
+    cout << oor.what() << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "DLL.h"
+#include "Queue.h"
+#include "Stack.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+/**
+ * Test of sizes and indices past 2^32 with one-byte elements. Each node
+ * still takes about 32 bytes from the allocator, so the default size
+ * needs roughly 140 GB of memory; it is not part of "make test". Run it
+ * with "make test-huge", or pass a smaller n to try it out.
+ *
+ * Usage: TestHugeDLL [n]
+ */
+int main(int argc, char *argv[]) {
+  const size_t big = (size_t(1) << 32) + 3u;
+  size_t n = argc > 1 ? strtoull(argv[1], 0, 10) : big;
+
+  cout << "building a list of " << n << " elements" << endl;
+
+  DLL<char> list;
+  for (size_t i = 0u; i < n; i++) {
+    list.addLast(i + 1u == n ? 'z' : 'a');
+  }
+  check(list.size() == n, "size");
+
+  // indices past 2^32 must not wrap around
+  check(list.contains('z') == n - 1u, "contains index");
+  check(list.contains('q') == DLL<char>::npos, "contains npos");
+  list.set(n - 2u, 'y');
+  check(list.get(n - 2u) == 'y', "get / set near the end");
+  check(list.remove(n - 2u) == 'y' && list.size() == n - 1u, "remove");
+
+  DLL<char> rest;
+  list.splitOff(n - 3u, rest);
+  check(list.size() == n - 3u && rest.size() == 2u, "splitOff");
+  list.splice(rest);
+  check(list.size() == n - 1u && list.getLast() == 'z', "splice");
+
+  list.clear();
+  check(list.isEmpty(), "clear");
+
+  // Stack and Queue report the same sizes
+  Stack<char> stack;
+  Queue<char> queue;
+  for (size_t i = 0u; i < n; i++) {
+    stack.push('s');
+  }
+  check(stack.size() == n, "stack size");
+  stack.clear();
+  for (size_t i = 0u; i < n; i++) {
+    queue.enqueue('q');
+  }
+  check(queue.size() == n, "queue size");
+
+  return finishChecks();
+}
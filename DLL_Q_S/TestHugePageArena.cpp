@@ -0,0 +1,67 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "DLL.h"
+#include "HugePageArena.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+/** DLL whose nodes come from a HugePageArena. */
+typedef DLL<int, Checked, ArenaAllocator<int> > ArenaDLL;
+
+int main() {
+  HugePageArena arena;
+  {
+    ArenaDLL list((ArenaAllocator<int>(arena)));
+
+    for (int i = 0; i < 10; i++) {
+      list.addFirst(i);
+    }
+    cout << list << " " << list.size() << endl;
+    cout << arena.regions() << " region(s), " << arena.bytesReserved()
+         << " bytes reserved, huge pages "
+         << (arena.hugePageRegions() > 0u ? "requested" : "unavailable")
+         << endl;
+
+    // copies share the arena, so nodes can move between the lists
+    ArenaDLL copy(list);
+    copy.sort();
+    list.sort();
+    list.merge(copy);
+    cout << list << " " << copy << endl;
+    check(list.size() == 20u && copy.isEmpty(), "merge within the arena");
+
+    // freed nodes are reused before the region grows
+    std::size_t before = arena.bytesReserved();
+    for (int r = 0; r < 1000; r++) {
+      list.removeFirst();
+      list.addLast(r);
+    }
+    check(arena.bytesReserved() == before, "free list reuse");
+
+    // enough nodes to need more than one region
+    for (int i = 0; i < 5000000; i++) {
+      list.addLast(i);
+    }
+    check(arena.regions() > 1u, "several regions");
+    check(list.getLast() == 4999999 && list.size() == 5000020u,
+          "large list");
+
+    // a region larger than the default for one big block
+    char *pBig = static_cast<char *>(arena.allocate(100u << 20, 8u));
+    pBig[(100u << 20) - 1u] = 'x';
+    arena.deallocate(pBig, 100u << 20);
+  }
+
+  // an arena without huge pages behaves the same
+  HugePageArena plain(HugePageArena::hugePageSize, false);
+  ArenaDLL small((ArenaAllocator<int>(plain)));
+  for (int i = 0; i < 100000; i++) {
+    small.addLast(i);
+  }
+  check(plain.hugePageRegions() == 0u && small.size() == 100000u,
+        "plain arena");
+
+  return finishChecks();
+}
@@ -0,0 +1,100 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include "DLL.h"
+#include "ParallelDLL.h"
+#include "TestCheck.h"
+#include "ThreadPool.h"
+
+int main() {
+  using namespace std;
+
+  ThreadPool pool(4u);
+
+  cout << "pool has " << pool.size() << " threads" << endl;
+
+  // small lists stay in one segment
+  DLL<int> small;
+  for (int i = 1; i <= 10; i++) {
+    small.addLast(i);
+  }
+  parallelTransform(pool, small, [](int a) { return a * a; });
+  cout << small << endl;
+  cout << "sum of squares: "
+       << parallelReduce(pool, small, 0, [](int a, int b) { return a + b; })
+       << endl;
+  cout << "odd squares: "
+       << parallelCountIf(pool, small, [](int a) { return a % 2 == 1; })
+       << endl;
+
+  DLL<int> empty;
+  cout << "reduce of empty list: "
+       << parallelReduce(pool, empty, 42, [](int a, int b) { return a + b; })
+       << endl;
+
+  // a large list is split across the pool
+  const unsigned n = 1000003u;
+  DLL<long> big;
+  for (unsigned i = 0u; i < n; i++) {
+    big.addLast(i);
+  }
+
+  parallelForEach(pool, big, [](long &a) { a += 1; });
+  long sum =
+      parallelReduce(pool, big, 0L, [](long a, long b) { return a + b; });
+  long expected = static_cast<long>(n) * (n + 1) / 2;
+  cout << "sum of 1.." << n << ": " << sum
+       << (sum == expected ? " (correct)" : " (WRONG)") << endl;
+  check(sum == expected, "sum of a large list");
+
+  unsigned multiples = parallelCountIf(pool, big, [](long a) {
+    return a % 7 == 0;
+  });
+  cout << "multiples of 7: " << multiples << endl;
+  check(multiples == n / 7u, "count of multiples of 7");
+
+  // a non-commutative but associative operation keeps list order
+  DLL<string> words;
+  for (unsigned i = 0u; i < 20000u; i++) {
+    words.addLast(string(1, static_cast<char>('a' + i % 26)));
+  }
+  string joined = parallelReduce(pool, words, string(">"),
+                                 [](const string &a, const string &b) {
+                                   return a + b;
+                                 });
+  bool ordered = joined.size() == 20001u && joined[0] == '>';
+  for (unsigned i = 0u; ordered && i < 20000u; i++) {
+    ordered = joined[i + 1u] == static_cast<char>('a' + i % 26);
+  }
+  cout << "concatenation " << (ordered ? "keeps" : "LOSES") << " list order"
+       << endl;
+  check(ordered, "concatenation keeps list order");
+
+  // parallel sort is stable: sort on the key only and check that equal
+  // keys keep their original order
+  DLL<pair<int, unsigned> > pairs;
+  unsigned seed = 246u;
+  for (unsigned i = 0u; i < 100000u; i++) {
+    seed = seed * 1103515245u + 12345u;
+    pairs.addLast(make_pair(static_cast<int>((seed >> 16) % 1000u), i));
+  }
+  parallelSort(pool, pairs,
+               [](const pair<int, unsigned> &a, const pair<int, unsigned> &b) {
+                 return a.first < b.first;
+               });
+  bool stable = pairs.size() == 100000u;
+  pair<int, unsigned> previous(-1, 0u);
+  for (DLL<pair<int, unsigned> >::Iterator it = pairs.begin();
+       it != pairs.end(); ++it) {
+    if ((*it).first < previous.first ||
+        ((*it).first == previous.first && (*it).second < previous.second)) {
+      stable = false;
+    }
+    previous = *it;
+  }
+  cout << "parallel sort " << (stable ? "is" : "is NOT") << " stable" << endl;
+  check(stable, "parallel sort is stable");
+
+  return finishChecks();
+}
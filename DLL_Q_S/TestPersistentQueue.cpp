@@ -0,0 +1,81 @@
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "PersistentQueue.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+int main() {
+  PersistentQueue<int> q1;
+
+  for (int i = 0; i < 10; i++) {
+    q1.enqueue(i);
+  }
+
+  cout << q1 << " " << q1.size() << endl;
+
+  // snapshots are O(1) and unaffected by later changes
+  PersistentQueue<int> snapshot(q1);
+
+  int first = q1.dequeue();
+  int second = q1.dequeue();
+  cout << "Dequeuing: " << first << " " << second << endl;
+  q1.enqueue(10);
+
+  cout << q1 << " " << q1.size() << endl;
+  cout << snapshot << " " << snapshot.size() << endl;
+  check(snapshot.size() == 10u && snapshot.peek() == 0, "snapshot kept");
+
+  // versions branch from a common queue
+  PersistentQueue<int> base = PersistentQueue<int>().enqueued(1).enqueued(2);
+  PersistentQueue<int> left = base.enqueued(3);
+  PersistentQueue<int> right = base.dequeued().enqueued(4);
+  cout << base << " " << left << " " << right << endl;
+  check(base.size() == 2u && left.size() == 3u && right.peek() == 2,
+        "versions branch");
+
+  q1.clear();
+  cout << "q1 " << (q1.isEmpty() ? "is" : "is not") << " empty" << endl;
+
+  PersistentQueue<int> q2(snapshot);
+  try {
+    while (true) {
+      cout << q2.dequeue() << " ";
+    }
+  } catch (std::out_of_range &oor) {
+    cout << oor.what() << endl;
+  }
+  check(snapshot.size() == 10u, "draining a copy leaves the original");
+
+  // random operations against std::deque, snapshotting along the way
+  mt19937 gen(246);
+  PersistentQueue<int> q;
+  deque<int> model;
+  PersistentQueue<int> saved;
+  deque<int> savedModel;
+  for (int i = 0; i < 100000; i++) {
+    if (gen() % 3u != 0u || model.empty()) {
+      q.enqueue(i);
+      model.push_back(i);
+    } else {
+      check(q.dequeue() == model.front(), "dequeue order");
+      model.pop_front();
+    }
+    if (i % 1000 == 0) {
+      saved = q;
+      savedModel = model;
+    }
+    check(q.size() == model.size(), "size");
+  }
+  while (!savedModel.empty()) {
+    check(saved.dequeue() == savedModel.front(), "snapshot order");
+    savedModel.pop_front();
+  }
+  check(saved.isEmpty(), "snapshot drained");
+
+  return finishChecks();
+}
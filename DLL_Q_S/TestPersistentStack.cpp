@@ -0,0 +1,105 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PersistentStack.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+int main() {
+  PersistentStack<int> stack;
+
+  for (int i = 0; i < 10; i++) {
+    stack.push(i);
+  }
+
+  cout << stack << " " << stack.size() << endl;
+
+  // snapshots are O(1) and unaffected by later changes
+  PersistentStack<int> snapshot(stack);
+  PersistentStack<int> st2;
+  st2 = stack;
+
+  int first = stack.pop();
+  int second = stack.pop();
+  cout << "Popping: " << first << " " << second << endl;
+  stack.push(42);
+
+  cout << stack << " " << stack.size() << endl;
+  cout << snapshot << " " << snapshot.size() << endl;
+  cout << st2 << " " << st2.size() << endl;
+  check(snapshot.size() == 10u && snapshot.peek() == 9, "snapshot kept");
+
+  // versions share their tails
+  PersistentStack<int> base = PersistentStack<int>().pushed(1).pushed(2);
+  PersistentStack<int> left = base.pushed(3);
+  PersistentStack<int> right = base.pushed(4).pushed(5);
+  PersistentStack<int> back = right.popped().popped();
+
+  cout << base << " " << left << " " << right << " " << back << endl;
+  check(left.popped().peek() == 2 && back.size() == base.size(),
+        "versions share tails");
+
+  // self-assignment keeps the stack
+  st2 = st2;
+  check(st2.size() == 10u && st2.peek() == 9, "self-assignment");
+
+  stack.clear();
+  cout << stack << " " << stack.size() << endl;
+
+  try {
+    cout << stack.peek() << endl;
+  } catch (std::out_of_range &oor) {
+    cout << oor.what() << endl;
+  }
+
+  try {
+    while (true) {
+      snapshot.pop();
+    }
+  } catch (std::out_of_range &oor) {
+    cout << oor.what() << endl;
+  }
+  check(st2.size() == 10u, "popping a copy leaves the original");
+
+  // releasing a very deep stack must not recurse
+  PersistentStack<int> deep;
+  for (int i = 0; i < 2000000; i++) {
+    deep.push(i);
+  }
+  PersistentStack<int> deepCopy(deep);
+  deep.clear();
+  check(deepCopy.size() == 2000000u, "deep copy survives");
+  deepCopy.clear();
+
+  // threads sharing a base version each build and drop their own
+  PersistentStack<string> shared;
+  for (int i = 0; i < 100; i++) {
+    shared.push(to_string(i));
+  }
+  vector<thread> threads;
+  vector<unsigned> sizes(4u, 0u);
+  for (unsigned t = 0u; t < 4u; t++) {
+    threads.emplace_back([&shared, &sizes, t]() {
+      for (int r = 0; r < 2000; r++) {
+        PersistentStack<string> mine(shared);
+        mine.push("x");
+        mine.pop();
+        mine.pop();
+        sizes[t] += mine.size();
+      }
+    });
+  }
+  for (thread &th : threads) {
+    th.join();
+  }
+  for (unsigned t = 0u; t < 4u; t++) {
+    check(sizes[t] == 2000u * 99u, "thread " + to_string(t));
+  }
+  check(shared.size() == 100u && shared.peek() == "99", "shared intact");
+
+  return finishChecks();
+}
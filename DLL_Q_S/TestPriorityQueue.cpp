@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "PriorityQueue.h"
+#include "TestCheck.h"
+
+/**
+ * Check that a priority queue, filled one element at a time or from a
+ * range, dequeues the values in the order a sort by the same comparator
+ * gives.
+ */
+template <class Compare, unsigned D>
+static void checkOrder(const std::vector<int> &values, Compare comp,
+                       const std::string &what) {
+  std::vector<int> expected(values);
+  std::sort(expected.begin(), expected.end(),
+            [&comp](int a, int b) { return comp(b, a); });
+
+  PriorityQueue<int, Compare, D> enqueued(comp);
+  for (std::size_t i = 0u; i < values.size(); i++) {
+    enqueued.enqueue(values[i]);
+  }
+  PriorityQueue<int, Compare, D> built(values.begin(), values.end(), comp);
+
+  std::vector<int> fromEnqueued, fromBuilt;
+  while (!enqueued.isEmpty()) {
+    fromEnqueued.push_back(enqueued.dequeue());
+  }
+  while (!built.isEmpty()) {
+    fromBuilt.push_back(built.dequeue());
+  }
+  check(fromEnqueued == expected, what + ", enqueued");
+  check(fromBuilt == expected, what + ", built from a range");
+}
+
+int main() {
+  using namespace std;
+
+  PriorityQueue<int> pq1;
+
+  int values[] = {5, 3, 8, 1, 9, 2, 7, 4, 6, 0};
+  for (int i = 0; i < 10; i++) {
+    pq1.enqueue(values[i]);
+  }
+
+  cout << pq1 << " " << pq1.size() << endl;
+
+  PriorityQueue<int> pq2(pq1);
+
+  cout << pq2 << " " << pq2.size() << endl;
+
+  cout << "pq2 " << (pq2.isEmpty() ? "is" : "is not") << " empty" << endl;
+
+  pq1.clear();
+
+  cout << "pq1 " << (pq1.isEmpty() ? "is" : "is not") << " empty" << endl;
+
+  cout << pq1 << endl;
+
+  cout << "peek: " << pq2.peek() << endl;
+
+  try {
+    while (true) {
+      cout << pq2.dequeue() << endl;
+    }
+  } catch (const std::out_of_range &oor) {
+    cout << oor.what() << endl;
+  }
+
+  // min-queue on a 4-ary heap, built from a range
+  PriorityQueue<int, greater<int>, 4> pq3(values, values + 10);
+  pq3.reserve(20u);
+
+  cout << pq3 << " " << pq3.size() << endl;
+
+  pq3.enqueue(-1);
+  while (!pq3.isEmpty()) {
+    cout << pq3.dequeue() << " ";
+  }
+  cout << endl;
+
+  // ties keep working with non-trivial payloads
+  PriorityQueue<string> pq4;
+  pq4.enqueue("pear");
+  pq4.enqueue("apple");
+  pq4.enqueue("quince");
+  pq4.enqueue("apple");
+
+  cout << pq4 << endl;
+
+  // dequeue order matches a sorted copy, with many duplicates, for
+  // binary and 4-ary heaps and both directions; a single element
+  // dequeues cleanly too
+  vector<int> many;
+  unsigned seed = 29u;
+  for (int i = 0; i < 1000; i++) {
+    seed = seed * 1103515245u + 12345u;
+    many.push_back(static_cast<int>((seed >> 16) % 100u));
+  }
+  checkOrder<less<int>, 2u>(many, less<int>(), "D = 2 max-queue");
+  checkOrder<greater<int>, 2u>(many, greater<int>(), "D = 2 min-queue");
+  checkOrder<less<int>, 4u>(many, less<int>(), "D = 4 max-queue");
+  checkOrder<greater<int>, 4u>(many, greater<int>(), "D = 4 min-queue");
+  checkOrder<less<int>, 2u>(vector<int>(1u, 7), less<int>(), "one element");
+
+  PriorityQueue<string> pq5;
+  pq5.enqueue("only");
+  check(pq5.dequeue() == "only" && pq5.isEmpty(), "dequeue last string");
+
+  return finishChecks();
+}
@@ -1,44 +1,91 @@
-#include <cstdlib>
-#include <iostream>
-#include <stdexcept>
-#include "Queue.h"
-
-int main() {
-  using namespace std;
-
-  Queue<int> q1;
-
-  for (int i = 0; i < 10; i++) {
-    q1.enqueue(i);
-  }
-
-  cout << q1 << " " << q1.size() << endl;
-
-  Queue<int> q2(q1);
-
-  cout << q2 << " " << q2.size() << endl;
-
-  cout << "q2 " << (q2.isEmpty() ? "is" : "is not") << " empty" << endl;
-
-  q1.clear();
-
-  cout << "q1 " << (q1.isEmpty() ? "is" : "is not") << " empty" << endl;
-
-  cout << q1 << endl;
-
-  Queue<int> q3;
-
-  q3 = q2;
-
-  try {
-    while (true) {
-      cout << q2.dequeue() << endl;
-    }
-  } catch (std::out_of_range oor) {
-    cout << oor.what() << endl;
-  }
-
-  cout << q3 << endl;
-
-  return EXIT_SUCCESS;
-}
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "Queue.h"
+#include "TestCheck.h"
+
+/**
+ * Get a queue as its printed text.
+ */
+static std::string text(const Queue<int> &queue) {
+  std::ostringstream out;
+  out << queue;
+  return out.str();
+}
+
+int main() {
+  using namespace std;
+
+  Queue<int> q1;
+
+  for (int i = 0; i < 10; i++) {
+    q1.enqueue(i);
+  }
+
+  cout << q1 << " " << q1.size() << endl;
+
+  Queue<int> q2(q1);
+
+  cout << q2 << " " << q2.size() << endl;
+
+  cout << "q2 " << (q2.isEmpty() ? "is" : "is not") << " empty" << endl;
+
+  q1.clear();
+
+  cout << "q1 " << (q1.isEmpty() ? "is" : "is not") << " empty" << endl;
+
+  cout << q1 << endl;
+
+  Queue<int> q3;
+
+  q3 = q2;
+
+  try {
+    while (true) {
+      cout << q2.dequeue() << endl;
+    }
+  } catch (std::out_of_range oor) {
+    cout << oor.what() << endl;
+  }
+
+  cout << q3 << endl;
+
+  // same behavior without checks, as long as the queue is never empty
+  Queue<int, Unchecked> fast;
+  Queue<int, DebugAssert> debug;
+  for (int i = 0; i < 10; i++) {
+    fast.enqueue(i);
+    debug.enqueue(i);
+  }
+  cout << fast << " " << debug << endl;
+  while (!fast.isEmpty()) {
+    cout << fast.dequeue() + debug.dequeue() << " ";
+  }
+  cout << endl;
+
+  // assignment to itself, and over a longer or shorter queue, which
+  // reuses nodes
+  Queue<int> a, b;
+  for (int i = 0; i < 5; i++) {
+    a.enqueue(i);
+  }
+  for (int i = 0; i < 8; i++) {
+    b.enqueue(10 + i);
+  }
+  Queue<int> &same = a;
+  a = same;
+  check(text(a) == "[0, 1, 2, 3, 4]" && a.size() == 5u, "self-assignment");
+  b = a;
+  check(text(b) == text(a) && b.size() == 5u, "assignment over longer");
+  for (int i = 5; i < 9; i++) {
+    a.enqueue(i);
+  }
+  b = a;
+  check(text(b) == "[0, 1, 2, 3, 4, 5, 6, 7, 8]" && b.size() == 9u,
+        "assignment over shorter");
+  cout << a << " " << b << endl;
+
+  return finishChecks();
+}
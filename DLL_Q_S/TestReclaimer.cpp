@@ -0,0 +1,116 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "DLL.h"
+#include "Queue.h"
+#include "Reclaimer.h"
+#include "Stack.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+int main() {
+  // a large list is detached at once and freed in the background, with
+  // its elements' destructors run
+  {
+    Reclaimer reclaimer(4u, 1000u);
+    shared_ptr<int> counted(new int(7));
+
+    DLL<shared_ptr<int> > list;
+    list.setReclaimer(&reclaimer);
+    for (int i = 0; i < 100000; i++) {
+      list.addLast(counted);
+    }
+    list.clear();
+    check(list.isEmpty() && list.size() == 0u, "cleared list is empty");
+
+    list.addLast(counted);
+    check(list.size() == 1u, "cleared list is usable");
+    list.clear();
+
+    reclaimer.drain();
+    check(counted.use_count() == 1, "elements destroyed");
+    check(reclaimer.freedInBackground() == 1u, "large list handed off");
+    check(reclaimer.freedInline() == 0u, "small list not counted");
+  }
+
+  // Stack and Queue pass the reclaimer on, and destruction uses it
+  {
+    Reclaimer reclaimer(4u, 10u);
+    {
+      Stack<string> stack;
+      Queue<string> queue;
+      stack.setReclaimer(&reclaimer);
+      queue.setReclaimer(&reclaimer);
+      for (int i = 0; i < 1000; i++) {
+        stack.push(to_string(i));
+        queue.enqueue(to_string(i));
+      }
+      cout << stack.pop() << " " << queue.dequeue() << endl;
+    }
+    reclaimer.drain();
+    check(reclaimer.freedInBackground() == 2u, "stack and queue handed off");
+
+    // a copy doesn't inherit the reclaimer
+    DLL<int> list;
+    list.setReclaimer(&reclaimer);
+    for (int i = 0; i < 100; i++) {
+      list.addLast(i);
+    }
+    DLL<int> copy(list);
+    copy.clear();
+    reclaimer.drain();
+    check(reclaimer.freedInBackground() == 2u, "copy frees synchronously");
+    list.setReclaimer(0);
+  }
+
+  // with the worker busy and the backlog full, the caller frees
+  {
+    Reclaimer reclaimer(1u, 1u);
+    atomic<bool> started(false), release(false);
+    reclaimer.retire([&started, &release]() {
+      started = true;
+      while (!release) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+      }
+    });
+    while (!started) {
+      this_thread::yield();
+    }
+
+    DLL<int> queued, overflow;
+    queued.setReclaimer(&reclaimer);
+    overflow.setReclaimer(&reclaimer);
+    for (int i = 0; i < 10; i++) {
+      queued.addLast(i);
+      overflow.addLast(i);
+    }
+    queued.clear();
+    overflow.clear();
+    check(reclaimer.freedInline() == 1u, "full backlog frees inline");
+
+    release = true;
+    reclaimer.drain();
+    check(reclaimer.freedInBackground() == 2u, "backlog drained");
+  }
+
+  // the destructor drains what is left
+  shared_ptr<int> counted(new int(1));
+  {
+    Reclaimer reclaimer(8u, 1u);
+    for (int r = 0; r < 8; r++) {
+      DLL<shared_ptr<int> > list;
+      list.setReclaimer(&reclaimer);
+      for (int i = 0; i < 10000; i++) {
+        list.addLast(counted);
+      }
+    }
+  }
+  check(counted.use_count() == 1, "destructor drains");
+
+  return finishChecks();
+}
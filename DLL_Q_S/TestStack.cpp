@@ -1,47 +1,106 @@
-#include <cstdlib>
-#include <iostream>
-#include <stdexcept>
-#include "Stack.h"
-
-int main() {
-  using namespace std;
-
-  Stack<int> stack;
-
-  for (int i = 0; i < 10; i++) {
-    stack.push(i);
-  }
-
-  cout << stack << " " << stack.size() << endl;
-
-  Stack<int> st1(stack);
-  Stack<int> st2;
-
-  st2 = st1;
-
-  cout << st1 << " " << st1.size() << endl;
-
-  cout << st2 << " " << st1.size() << endl;
-
-  stack.clear();
-
-  cout << stack << " " << stack.size() << endl;
-
-  cout << st1.peek() << endl;
-
-  try {
-    cout << stack.peek() << endl;
-  } catch (std::out_of_range oor) {
-    cout << oor.what() << endl;
-  }
-
-  try {
-    while (true) {
-      cout << st1.pop() << endl;
-    }
-  } catch (std::out_of_range oor) {
-    cout << oor.what() << endl;
-  }
-
-  return EXIT_SUCCESS;
-}
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "Stack.h"
+#include "TestCheck.h"
+
+/**
+ * Get a stack as its printed text.
+ */
+static std::string text(const Stack<int> &stack) {
+  std::ostringstream out;
+  out << stack;
+  return out.str();
+}
+
+int main() {
+  using namespace std;
+
+  Stack<int> stack;
+
+  for (int i = 0; i < 10; i++) {
+    stack.push(i);
+  }
+
+  cout << stack << " " << stack.size() << endl;
+
+  Stack<int> st1(stack);
+  Stack<int> st2;
+
+  st2 = st1;
+
+  cout << st1 << " " << st1.size() << endl;
+
+  cout << st2 << " " << st1.size() << endl;
+
+  stack.clear();
+
+  cout << stack << " " << stack.size() << endl;
+
+  cout << st1.peek() << endl;
+
+  try {
+    cout << stack.peek() << endl;
+  } catch (std::out_of_range oor) {
+    cout << oor.what() << endl;
+  }
+
+  try {
+    while (true) {
+      cout << st1.pop() << endl;
+    }
+  } catch (std::out_of_range oor) {
+    cout << oor.what() << endl;
+  }
+
+  // same behavior without checks, as long as the stack is never empty
+  Stack<int, Unchecked> fast;
+  Stack<int, DebugAssert> debug;
+  for (int i = 0; i < 10; i++) {
+    fast.push(i);
+    debug.push(i);
+  }
+  cout << fast << " " << debug << endl;
+  cout << fast.peek() << " " << debug.peek() << endl;
+  while (!fast.isEmpty()) {
+    cout << fast.pop() + debug.pop() << " ";
+  }
+  cout << endl;
+
+  // tryPop and tryPeek report an empty stack instead of throwing
+  int top = -1;
+  st2.push(42);
+  cout << st2.tryPeek(top) << " " << top << endl;
+  while (st2.tryPop(top)) {
+    cout << top << " ";
+  }
+  cout << endl;
+  top = -1;
+  cout << st2.tryPeek(top) << " " << st2.tryPop(top) << " " << top << endl;
+
+  // assignment to itself, and over a longer or shorter stack, which
+  // reuses nodes
+  Stack<int> a, b;
+  for (int i = 0; i < 5; i++) {
+    a.push(i);
+  }
+  for (int i = 0; i < 8; i++) {
+    b.push(10 + i);
+  }
+  Stack<int> &same = a;
+  a = same;
+  check(text(a) == "[4, 3, 2, 1, 0]" && a.size() == 5u, "self-assignment");
+  b = a;
+  check(text(b) == text(a) && b.size() == 5u, "assignment over longer");
+  for (int i = 5; i < 9; i++) {
+    a.push(i);
+  }
+  b = a;
+  check(text(b) == "[8, 7, 6, 5, 4, 3, 2, 1, 0]" && b.size() == 9u,
+        "assignment over shorter");
+  cout << a << " " << b << endl;
+
+  return finishChecks();
+}
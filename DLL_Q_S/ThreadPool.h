@@ -0,0 +1,167 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Queue.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a fixed pool of worker threads that run submitted
+ * jobs, taken in order from a Queue.
+ */
+class ThreadPool {
+public:
+  /**
+   * Constructor. Start the worker threads.
+   *
+   * \param nThreads Number of worker threads; 0 means one per hardware
+   * thread.
+   */
+  explicit ThreadPool(unsigned nThreads = 0u);
+
+  /**
+   * Destructor. Finish the queued jobs and stop the workers.
+   */
+  ~ThreadPool();
+
+  /**
+   * Get the number of worker threads.
+   *
+   * \return Number of worker threads.
+   */
+  unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+  /**
+   * Queue a job to run on a worker thread.
+   *
+   * \param job Job to run.
+   */
+  void submit(const std::function<void()> &job);
+
+  /**
+   * Wait until every submitted job has finished.
+   */
+  void wait();
+
+private:
+  ThreadPool(const ThreadPool &);
+  ThreadPool &operator=(const ThreadPool &);
+
+  /** Worker threads. */
+  std::vector<std::thread> workers;
+
+  /** Jobs waiting to run. */
+  Queue<std::function<void()> > jobs;
+
+  /** Number of jobs submitted but not finished. */
+  unsigned pending;
+
+  /** Set by the destructor to stop the workers. */
+  bool stopping;
+
+  /** Lock protecting jobs, pending and stopping. */
+  std::mutex mutex;
+
+  /** Signaled when a job is queued or the pool is stopping. */
+  std::condition_variable jobReady;
+
+  /** Signaled when pending drops to zero. */
+  std::condition_variable allDone;
+
+  /**
+   * Worker thread body: run jobs until the pool stops.
+   */
+  void work();
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the constructor.
+ */
+inline ThreadPool::ThreadPool(unsigned nThreads)
+    : pending(0u), stopping(false) {
+  if (nThreads == 0u) {
+    nThreads = std::thread::hardware_concurrency();
+  }
+  if (nThreads == 0u) {
+    nThreads = 1u;
+  }
+  for (unsigned i = 0u; i < nThreads; i++) {
+    workers.push_back(std::thread(&ThreadPool::work, this));
+  }
+}
+
+/*
+ * Implementation of the destructor.
+ */
+inline ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  jobReady.notify_all();
+  for (size_t i = 0u; i < workers.size(); i++) {
+    workers[i].join();
+  }
+}
+
+/*
+ * Implementation of submit.
+ */
+inline void ThreadPool::submit(const std::function<void()> &job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.enqueue(job);
+    pending++;
+  }
+  jobReady.notify_one();
+}
+
+/*
+ * Implementation of wait.
+ */
+inline void ThreadPool::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (pending > 0u) {
+    allDone.wait(lock);
+  }
+}
+
+/*
+ * Implementation of the worker thread body.
+ */
+inline void ThreadPool::work() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (jobs.isEmpty() && !stopping) {
+        jobReady.wait(lock);
+      }
+      if (jobs.isEmpty()) {
+        return;
+      }
+      job = jobs.dequeue();
+    }
+
+    job();
+
+    bool last;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      last = --pending == 0u;
+    }
+    if (last) {
+      allDone.notify_all();
+    }
+  }
+}
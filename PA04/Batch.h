@@ -0,0 +1,368 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Bytecode.h"
+#include "Session.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a batch of expressions as one hash-consed DAG:
+ * every distinct subexpression, e.g., "3 4 +", is a single node however
+ * many expressions contain it, so evaluating the batch computes it
+ * once. Nodes are only made after their operands, so the node list is
+ * already in evaluation order.
+ *
+ * Values are exactly those run() gives, optimized, fused or not: each
+ * node is one IEEE double operation on the values of its operands,
+ * and equal subexpressions have equal values. Constants are matched by
+ * bit pattern, so 0 and -0 are different nodes.
+ */
+class ExpressionBatch {
+public:
+  /**
+   * Constructor. Make an empty batch.
+   */
+  ExpressionBatch() : operations(0u), evaluated(0u) {}
+
+  /**
+   * Add an expression to the batch.
+   *
+   * \param program Unfused, unoptimized program for the expression,
+   * which checkDepth() accepts without parameters.
+   *
+   * \return Node number of the expression, for value().
+   */
+  std::size_t add(const Program &program);
+
+  /**
+   * Remove every expression and node, keeping the statistics.
+   */
+  void clear();
+
+  /**
+   * Get the number of distinct subexpressions, which is the number of
+   * operations evaluate() performs.
+   *
+   * \return Number of nodes.
+   */
+  std::size_t distinct() const { return nodes.size(); }
+
+  /**
+   * Compute the value of every node not evaluated yet.
+   */
+  void evaluate();
+
+  /**
+   * Get the number of nodes evaluated since construction.
+   *
+   * \return Number of operations performed.
+   */
+  std::uint64_t evaluatedCount() const { return evaluated; }
+
+  /**
+   * Get the number of operations the expressions contain, which is how
+   * many evaluating them one at a time would take.
+   *
+   * \return Number of instructions added since construction.
+   */
+  std::uint64_t operationCount() const { return operations; }
+
+  /**
+   * Get the value of an expression, after evaluate().
+   *
+   * \param node Node number from add().
+   *
+   * \return Value of the expression.
+   */
+  double value(std::size_t node) const { return values[node]; }
+
+private:
+  /** One distinct subexpression. */
+  struct Node {
+    /** OP_PUSH, or the binary operation. */
+    OpCode op;
+
+    /** Bit pattern of the constant, for OP_PUSH; otherwise 0. */
+    std::uint64_t bits;
+
+    /** Node number of the left operand, or 0 for OP_PUSH. */
+    std::uint32_t lhs;
+
+    /** Node number of the right operand, or 0 for OP_PUSH. */
+    std::uint32_t rhs;
+
+    /** Equality operator, for the hash table. */
+    bool operator==(const Node &node) const {
+      return op == node.op && bits == node.bits && lhs == node.lhs &&
+             rhs == node.rhs;
+    }
+
+    /** Hash function, mixing every field into every bit. */
+    std::uint64_t hash() const {
+      std::uint64_t h = bits ^ (std::uint64_t(lhs) << 32 | rhs) * 31u ^ op;
+      h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+      h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ull;
+      return h ^ (h >> 33);
+    }
+  };
+
+  /** The nodes, operands first. */
+  std::vector<Node> nodes;
+
+  /** Values of the nodes evaluated so far. */
+  std::vector<double> values;
+
+  /**
+   * Open-addressed hash table for finding an existing node; a power of
+   * two in size, at most half full. Each slot is the node's hash in the
+   * high 32 bits and its number plus one in the low, or 0 if free, so
+   * probing stays within a cache line or two and only a matching hash
+   * reads the node, where a node-based map would miss on every lookup.
+   */
+  std::vector<std::uint64_t> table;
+
+  /** Node numbers of the operands while adding, reused. */
+  std::vector<std::uint32_t> stack;
+
+  /** Number of instructions added. */
+  std::uint64_t operations;
+
+  /** Number of nodes evaluated. */
+  std::uint64_t evaluated;
+
+  /**
+   * Find a node, making it if it is new.
+   */
+  std::uint32_t intern(const Node &node);
+};
+
+/**
+ * Class representing a calculator session in batch mode: expressions
+ * are collected, evaluated together as an ExpressionBatch, and their
+ * output lines are produced in order when the batch is flushed. Output
+ * is the same as Session's in the double engine.
+ */
+class BatchSession {
+public:
+  /**
+   * Constructor. Make a session with nothing read yet.
+   */
+  BatchSession() : discarding(false) {}
+
+  /**
+   * Feed the next token; output waits for flush().
+   *
+   * \param token Number, operator or "E".
+   */
+  void feed(const std::string &token);
+
+  /**
+   * Evaluate the expressions completed since the last flush and append
+   * their output lines, in order. An expression still being read is
+   * kept for the next flush.
+   *
+   * \param out String to append output lines to.
+   */
+  void flush(std::string &out);
+
+  /**
+   * Get the batch statistics.
+   *
+   * \return The batch, for its operation and evaluation counts.
+   */
+  const ExpressionBatch &statistics() const { return batch; }
+
+  /**
+   * Get the number of expressions waiting for flush().
+   *
+   * \return Number of complete expressions not yet output.
+   */
+  std::size_t waiting() const { return lines.size(); }
+
+private:
+  /** Output of one expression: an error, or the node of its value. */
+  struct Line {
+    /** Error message, or empty. */
+    std::string error;
+
+    /** Node number of the value, if there is no error. */
+    std::size_t node;
+  };
+
+  /** Expressions waiting for flush(). */
+  std::vector<Line> lines;
+
+  /** The waiting expressions' DAG. */
+  ExpressionBatch batch;
+
+  /** Program for the expression being read. */
+  Program program;
+
+  /** Set after an error, so the rest of the bad expression is skipped. */
+  bool discarding;
+
+  /** Error message for the expression being read, if discarding. */
+  std::string error;
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the add method: the postfix program is run
+ * symbolically, with node numbers on the stack instead of values.
+ */
+inline std::size_t ExpressionBatch::add(const Program &program) {
+  stack.clear();
+  operations += program.size();
+
+  for (std::size_t i = 0u; i < program.size(); i++) {
+    const Instruction &ins = program[i];
+    Node node = {ins.op, 0u, 0u, 0u};
+    if (ins.op == OP_PUSH) {
+      std::memcpy(&node.bits, &ins.imm, sizeof(double));
+    } else {
+      node.rhs = stack.back();
+      stack.pop_back();
+      node.lhs = stack.back();
+      stack.pop_back();
+    }
+    stack.push_back(intern(node));
+  }
+
+  return stack.back();
+}
+
+/*
+ * Implementation of the clear method.
+ */
+inline void ExpressionBatch::clear() {
+  nodes.clear();
+  values.clear();
+  table.clear();
+}
+
+/*
+ * Implementation of the evaluate method.
+ */
+inline void ExpressionBatch::evaluate() {
+  std::size_t first = values.size();
+  values.resize(nodes.size());
+
+  for (std::size_t i = first; i < nodes.size(); i++) {
+    const Node &node = nodes[i];
+    double lhs = values[node.lhs], rhs = values[node.rhs];
+
+    switch (node.op) {
+    case OP_ADD:
+      values[i] = lhs + rhs;
+      break;
+    case OP_SUB:
+      values[i] = lhs - rhs;
+      break;
+    case OP_MUL:
+      values[i] = lhs * rhs;
+      break;
+    case OP_DIV:
+      values[i] = lhs / rhs;
+      break;
+    default:
+      std::memcpy(&values[i], &node.bits, sizeof(double));
+    }
+  }
+
+  evaluated += nodes.size() - first;
+}
+
+/*
+ * Implementation of the intern method, with linear probing; the table
+ * doubles, and is rebuilt from the nodes, when it would be half full.
+ */
+inline std::uint32_t ExpressionBatch::intern(const Node &node) {
+  const std::uint64_t high = 0xffffffff00000000ull;
+
+  if (2u * (nodes.size() + 1u) > table.size()) {
+    table.assign(table.empty() ? 1024u : 2u * table.size(), 0u);
+    std::size_t mask = table.size() - 1u;
+    for (std::size_t i = 0u; i < nodes.size(); i++) {
+      std::uint64_t hash = nodes[i].hash();
+      std::size_t slot = hash & mask;
+      while (table[slot] != 0u) {
+        slot = (slot + 1u) & mask;
+      }
+      table[slot] = (hash & high) | (i + 1u);
+    }
+  }
+
+  std::uint64_t hash = node.hash();
+  std::size_t mask = table.size() - 1u;
+  std::size_t slot = hash & mask;
+  while (table[slot] != 0u) {
+    std::uint32_t number = static_cast<std::uint32_t>(table[slot]) - 1u;
+    if ((table[slot] & high) == (hash & high) && nodes[number] == node) {
+      return number;
+    }
+    slot = (slot + 1u) & mask;
+  }
+  nodes.push_back(node);
+  table[slot] = (hash & high) | nodes.size();
+  return static_cast<std::uint32_t>(nodes.size() - 1u);
+}
+
+/*
+ * Implementation of the feed method, which checks expressions as
+ * Session does so that the errors are the same.
+ */
+inline void BatchSession::feed(const std::string &token) {
+  if (token == "E") {
+    Line line;
+    line.node = 0u;
+    if (discarding) {
+      line.error = error;
+    } else {
+      RunStatus status = checkDepth(program);
+      if (status == RUN_OK) {
+        line.node = batch.add(program);
+      } else {
+        line.error = runStatusMessage(status);
+      }
+    }
+    lines.push_back(line);
+    program.clear();
+    discarding = false;
+  } else if (!discarding && !compileToken(token, program)) {
+    error = "Bad token " + token;
+    discarding = true;
+  }
+}
+
+/*
+ * Implementation of the flush method.
+ */
+inline void BatchSession::flush(std::string &out) {
+  batch.evaluate();
+
+  for (std::size_t i = 0u; i < lines.size(); i++) {
+    out += ">>> ";
+    if (lines[i].error.empty()) {
+      char text[32];
+      formatValue(text, sizeof(text), batch.value(lines[i].node));
+      out += text;
+    } else {
+      out += "Error: ";
+      out += lines[i].error;
+    }
+    out += '\n';
+  }
+
+  lines.clear();
+  batch.clear();
+}
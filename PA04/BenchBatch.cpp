@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Batch.h"
+#include "Session.h"
+#include "Workload.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Time a session and a batch session over the same tokens, checking
+ * that they reply the same, and print the nanoseconds per expression
+ * and the evaluations the batch saved. The batch is flushed every
+ * batchSize expressions, as the calculator's --batch mode does.
+ */
+static bool compare(const string &name, const vector<string> &tokens,
+                    size_t batchSize) {
+  size_t expressions = 0u;
+  for (size_t i = 0u; i < tokens.size(); i++) {
+    expressions += tokens[i] == "E";
+  }
+
+  Session session;
+  string out;
+  steady_clock::time_point t0 = steady_clock::now();
+  for (size_t i = 0u; i < tokens.size(); i++) {
+    session.feed(tokens[i], out);
+  }
+
+  BatchSession batch;
+  string batchOut;
+  steady_clock::time_point t1 = steady_clock::now();
+  for (size_t i = 0u; i < tokens.size(); i++) {
+    batch.feed(tokens[i]);
+    if (batch.waiting() == batchSize) {
+      batch.flush(batchOut);
+    }
+  }
+  batch.flush(batchOut);
+  steady_clock::time_point t2 = steady_clock::now();
+
+  if (out != batchOut) {
+    cerr << name << ": batch replies differ" << endl;
+    return false;
+  }
+  const ExpressionBatch &stats = batch.statistics();
+  double ns = duration<double, nano>(t1 - t0).count() / expressions;
+  double nsBatch = duration<double, nano>(t2 - t1).count() / expressions;
+  cout << name << ": " << expressions << " expressions, "
+       << stats.operationCount() << " operations, "
+       << stats.operationCount() - stats.evaluatedCount() << " saved"
+       << endl;
+  cout << "  session:        " << ns << " ns/expression" << endl;
+  cout << "  batch session:  " << nsBatch << " ns/expression" << endl;
+  return true;
+}
+
+/**
+ * Benchmark of batch mode: a session against a batch session, which
+ * evaluates each distinct subexpression once, on an input file repeated
+ * as one batch, where most subexpressions recur, and on a generated
+ * workload, where few do.
+ *
+ * Usage: BenchBatch [file [repeats [batch-size]]]
+ */
+int main(int argc, char *argv[]) {
+  const char *path = argc > 1 ? argv[1] : "input.txt";
+  long repeats = argc > 2 ? atol(argv[2]) : 20000;
+  size_t batchSize = argc > 3 ? atol(argv[3]) : 65536;
+
+  ifstream in(path);
+  vector<string> file, tokens;
+  string token;
+  while (in >> token) {
+    file.push_back(token);
+  }
+  for (long r = 0; r < repeats; r++) {
+    tokens.insert(tokens.end(), file.begin(), file.end());
+  }
+  if (file.empty() || !compare(path, tokens, batchSize)) {
+    return EXIT_FAILURE;
+  }
+
+  WorkloadOptions options;
+  options.expressions = 200000;
+  ostringstream workload;
+  generateWorkload(options, workload, 0);
+  istringstream generated(workload.str());
+  tokens.clear();
+  while (generated >> token) {
+    tokens.push_back(token);
+  }
+  if (!compare("generated", tokens, batchSize)) {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
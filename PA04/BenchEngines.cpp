@@ -0,0 +1,135 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Bytecode.h"
+#include "Fixed.h"
+#include "Session.h"
+#include "Stack.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Time running the fused programs in one number type, returning the
+ * nanoseconds per expression and storing each expression's value, as a
+ * double, in values.
+ */
+template <class Num>
+double timeRun(const vector<Program> &programs, long reps,
+               vector<double> &values) {
+  vector<BasicProgram<Num> > converted(programs.size());
+  for (size_t i = 0u; i < programs.size(); i++) {
+    convertProgram(programs[i], converted[i]);
+  }
+
+  Stack<Num> stack;
+  values.assign(programs.size(), 0.0);
+  steady_clock::time_point start = steady_clock::now();
+
+  for (long r = 0; r < reps; r++) {
+    for (size_t i = 0u; i < converted.size(); i++) {
+      values[i] = static_cast<double>(run(converted[i], stack));
+    }
+  }
+
+  double ns = duration<double, nano>(steady_clock::now() - start).count();
+  return ns / (static_cast<double>(reps) * programs.size());
+}
+
+/**
+ * Time a session in one engine over every token, returning the
+ * nanoseconds per expression. This includes compiling, checking,
+ * converting and formatting.
+ */
+double timeSession(Engine engine, const vector<string> &tokens, long reps,
+                   size_t expressions) {
+  Session session(engine);
+  string out;
+  steady_clock::time_point start = steady_clock::now();
+
+  for (long r = 0; r < reps; r++) {
+    for (size_t i = 0u; i < tokens.size(); i++) {
+      session.feed(tokens[i], out);
+    }
+    out.clear();
+  }
+
+  double ns = duration<double, nano>(steady_clock::now() - start).count();
+  return ns / (static_cast<double>(reps) * expressions);
+}
+
+/**
+ * Benchmark of the numeric engines: evaluation time per expression in
+ * double, float, long double and fixed point over the fused programs of
+ * a postfix input file, the time through a whole Session, and the
+ * largest difference of each engine's values from double's.
+ *
+ * Usage: BenchEngines [file [repetitions]]
+ */
+int main(int argc, char *argv[]) {
+  const char *fileName = argc > 1 ? argv[1] : "input.txt";
+  long reps = argc > 2 ? atol(argv[2]) : 200000;
+
+  ifstream in(fileName);
+  vector<string> tokens;
+  vector<Program> programs;
+  Program program;
+  string token;
+  while (in >> token) {
+    tokens.push_back(token);
+    if (token == "E") {
+      fuse(program);
+      programs.push_back(program);
+      program.clear();
+    } else if (!compileToken(token, program)) {
+      cerr << "Bad token " << token << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (programs.empty()) {
+    cerr << "No expressions in " << fileName << endl;
+    return EXIT_FAILURE;
+  }
+
+  const char *names[] = {"double     ", "float      ", "long-double",
+                         "fixed      "};
+  vector<double> reference, values;
+
+  cout << programs.size() << " expressions, " << reps << " repetitions"
+       << endl;
+  cout << "engine       run ns/expr  session ns/expr  max difference" << endl;
+
+  for (int e = 0; e < 4; e++) {
+    Engine engine = static_cast<Engine>(e);
+    double ns = 0.0;
+    switch (engine) {
+    case ENGINE_FLOAT:
+      ns = timeRun<float>(programs, reps, values);
+      break;
+    case ENGINE_LONG_DOUBLE:
+      ns = timeRun<long double>(programs, reps, values);
+      break;
+    case ENGINE_FIXED:
+      ns = timeRun<Fixed>(programs, reps, values);
+      break;
+    default:
+      ns = timeRun<double>(programs, reps, reference);
+      values = reference;
+    }
+
+    double maxDifference = 0.0;
+    for (size_t i = 0u; i < values.size(); i++) {
+      maxDifference = max(maxDifference, fabs(values[i] - reference[i]));
+    }
+
+    cout << names[e] << "  " << ns << "\t    "
+         << timeSession(engine, tokens, reps / 10 + 1, programs.size())
+         << "\t     " << maxDifference << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
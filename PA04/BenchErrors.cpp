@@ -0,0 +1,144 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Bytecode.h"
+#include "Optimizer.h"
+#include "Session.h"
+#include "Stack.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * The calculator loop as it was before checkDepth: malformed
+ * expressions are caught as exceptions from run(). Output is formatted
+ * as Session formats it. Returns the number of output lines.
+ */
+long runThrowing(const vector<string> &tokens) {
+  Stack<double> stack;
+  Program program;
+  bool discarding = false;
+  long lines = 0;
+  string out;
+
+  for (size_t i = 0u; i < tokens.size(); i++) {
+    const string &token = tokens[i];
+    if (token == "E") {
+      if (!discarding) {
+        try {
+          optimize(program);
+          fuse(program);
+          char text[32];
+          snprintf(text, sizeof(text), "%g", run(program, stack));
+          out = ">>> ";
+          out += text;
+        } catch (const exception &e) {
+          out = ">>> Error: ";
+          out += e.what();
+          stack.clear();
+        }
+        lines++;
+      }
+      program.clear();
+      discarding = false;
+    } else if (!discarding && !compileToken(token, program)) {
+      out = ">>> Error: Bad token " + token;
+      discarding = true;
+      lines++;
+    }
+  }
+
+  return lines;
+}
+
+/**
+ * The calculator loop with a Session, which checks stack depth before
+ * running. Returns the number of output lines.
+ */
+long runChecked(const vector<string> &tokens) {
+  Session session;
+  string out;
+  long lines = 0;
+
+  for (size_t i = 0u; i < tokens.size(); i++) {
+    session.feed(tokens[i], out);
+    if (!out.empty()) {
+      lines++;
+      out.clear();
+    }
+  }
+
+  return lines;
+}
+
+/**
+ * Benchmark of the calculator on input where a given share of the
+ * expressions are malformed (half too few operands, half too many),
+ * catching exceptions from run() against checking stack depth first.
+ * Valid expressions come from a postfix input file.
+ *
+ * Usage: BenchErrors [file [expressions]]
+ */
+int main(int argc, char *argv[]) {
+  const char *fileName = argc > 1 ? argv[1] : "input.txt";
+  long count = argc > 2 ? atol(argv[2]) : 500000;
+
+  ifstream in(fileName);
+  vector<vector<string> > valid(1u);
+  string token;
+  while (in >> token) {
+    valid.back().push_back(token);
+    if (token == "E") {
+      valid.push_back(vector<string>());
+    }
+  }
+  valid.pop_back();
+  if (valid.empty()) {
+    cerr << "No expressions in " << fileName << endl;
+    return EXIT_FAILURE;
+  }
+
+  const char *underflow[] = {"3", "4", "+", "*", "E"};
+  const char *leftover[] = {"3", "4", "5", "+", "E"};
+
+  cout << count << " expressions, thousands of expressions/s" << endl;
+  cout << "malformed  exceptions  checkDepth" << endl;
+
+  const int shares[] = {0, 10, 50};
+  for (int share : shares) {
+    mt19937 gen(44);
+    vector<string> tokens;
+    for (long i = 0; i < count; i++) {
+      if (long(gen() % 100u) < share) {
+        const char **bad = i % 2 == 0 ? underflow : leftover;
+        tokens.insert(tokens.end(), bad, bad + 5);
+      } else {
+        const vector<string> &expr = valid[gen() % valid.size()];
+        tokens.insert(tokens.end(), expr.begin(), expr.end());
+      }
+    }
+
+    steady_clock::time_point t0 = steady_clock::now();
+    long a = runThrowing(tokens);
+    steady_clock::time_point t1 = steady_clock::now();
+    long b = runChecked(tokens);
+    steady_clock::time_point t2 = steady_clock::now();
+
+    if (a != count || b != count) {
+      cerr << "Wrong number of results" << endl;
+      return EXIT_FAILURE;
+    }
+    double msThrowing = duration<double, milli>(t1 - t0).count();
+    double msChecked = duration<double, milli>(t2 - t1).count();
+    cout << share << "%\t   " << count / msThrowing << "\t       "
+         << count / msChecked << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Bytecode.h"
+#include "Infix.h"
+#include "Stack.h"
+#include "Workload.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Make a random infix expression with up to a given nesting depth, with
+ * numbers in every format, parentheses and unary minus.
+ */
+static string randomInfix(int depth, mt19937 &gen) {
+  unsigned pick = depth == 0 ? 0u : gen() % 8u;
+
+  if (pick < 2u) {
+    return randomNumber("idse"[gen() % 4u], gen);
+  } else if (pick == 2u) {
+    return "(" + randomInfix(depth - 1, gen) + ")";
+  } else if (pick == 3u) {
+    return "-(" + randomInfix(depth - 1, gen) + ")";
+  }
+  string lhs = randomInfix(depth - 1, gen);
+  string rhs = randomInfix(depth - 1, gen);
+  return lhs + " " + "+-*/"[gen() % 4u] + " " + rhs;
+}
+
+/**
+ * Append an operator from the operator stack to postfix text.
+ */
+static void appendOperator(char op, string &postfix) {
+  postfix += op == 'n' ? "-1 * " : string(1u, op) + " ";
+}
+
+/**
+ * The two-step path: convert infix to postfix text with the same
+ * shunting-yard rules as compileInfix(), as an upstream converter
+ * would. Returns false on a syntax error.
+ */
+static bool infixToPostfix(const string &text, string &postfix) {
+  Stack<char> operators;
+  bool expectOperand = true;
+  size_t i = 0u, n = text.size();
+
+  postfix.clear();
+  while (true) {
+    while (i < n && text[i] == ' ') {
+      i++;
+    }
+    if (i == n) {
+      break;
+    }
+    char c = text[i];
+
+    if (expectOperand) {
+      size_t end = scanInfixOperand(text, i);
+      if (c == '(') {
+        operators.push('(');
+        i++;
+      } else if ((c == '-' || c == '+') && end == i) {
+        if (c == '-') {
+          operators.push('n');
+        }
+        i++;
+      } else if (end > i) {
+        postfix.append(text, i, end - i);
+        postfix += ' ';
+        expectOperand = false;
+        i = end;
+      } else {
+        return false;
+      }
+    } else if (c == ')') {
+      while (!operators.isEmpty() && operators.peek() != '(') {
+        appendOperator(operators.pop(), postfix);
+      }
+      if (operators.isEmpty()) {
+        return false;
+      }
+      operators.pop();
+      i++;
+    } else if (strchr("+-*/", c)) {
+      while (!operators.isEmpty() && operators.peek() != '(' &&
+             infixPrecedence(operators.peek()) >= infixPrecedence(c)) {
+        appendOperator(operators.pop(), postfix);
+      }
+      operators.push(c);
+      expectOperand = true;
+      i++;
+    } else {
+      return false;
+    }
+  }
+
+  while (!operators.isEmpty()) {
+    char op = operators.pop();
+    if (op == '(') {
+      return false;
+    }
+    appendOperator(op, postfix);
+  }
+  return !expectOperand;
+}
+
+/**
+ * The rest of the two-step path: parse the postfix text again, as the
+ * calculator does, into a program.
+ */
+static bool compilePostfix(const string &postfix, Program &program) {
+  istringstream in(postfix);
+  string token;
+
+  program.clear();
+  while (in >> token) {
+    if (!compileToken(token, program)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Determine if two programs are the same, bit for bit.
+ */
+static bool samePrograms(const Program &a, const Program &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0u; i < a.size(); i++) {
+    if (a[i].op != b[i].op ||
+        memcmp(&a[i].imm, &b[i].imm, sizeof(double)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Benchmark of the infix front end: compiling random infix expressions
+ * into programs in one pass with compileInfix(), against converting
+ * them to postfix text and parsing that as the calculator would. Both
+ * must give the same programs.
+ *
+ * Usage: BenchInfix [expressions [depth]]
+ */
+int main(int argc, char *argv[]) {
+  long count = argc > 1 ? atol(argv[1]) : 200000;
+  int depth = argc > 2 ? atoi(argv[2]) : 5;
+
+  mt19937 gen(48);
+  vector<string> exprs;
+  size_t chars = 0u;
+  for (long i = 0; i < count; i++) {
+    exprs.push_back(randomInfix(depth, gen));
+    chars += exprs.back().size();
+  }
+
+  vector<Program> direct(exprs.size()), twoStep(exprs.size());
+  string error, postfix;
+
+  steady_clock::time_point t0 = steady_clock::now();
+  for (size_t i = 0u; i < exprs.size(); i++) {
+    if (!compileInfix(exprs[i], direct[i], error)) {
+      cerr << exprs[i] << ": " << error << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  steady_clock::time_point t1 = steady_clock::now();
+  for (size_t i = 0u; i < exprs.size(); i++) {
+    if (!infixToPostfix(exprs[i], postfix) ||
+        !compilePostfix(postfix, twoStep[i])) {
+      cerr << exprs[i] << ": conversion failed" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  steady_clock::time_point t2 = steady_clock::now();
+
+  size_t instructions = 0u;
+  for (size_t i = 0u; i < exprs.size(); i++) {
+    if (!samePrograms(direct[i], twoStep[i])) {
+      cerr << exprs[i] << ": programs differ" << endl;
+      return EXIT_FAILURE;
+    }
+    instructions += direct[i].size();
+  }
+
+  double nsDirect = duration<double, nano>(t1 - t0).count() / count;
+  double nsTwoStep = duration<double, nano>(t2 - t1).count() / count;
+  cout << count << " expressions, " << chars / count << " characters and "
+       << instructions / count << " instructions each" << endl;
+  cout << "infix -> program:                  " << nsDirect
+       << " ns/expression" << endl;
+  cout << "infix -> postfix text -> program:  " << nsTwoStep
+       << " ns/expression" << endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Bytecode.h"
+#include "Optimizer.h"
+#include "Stack.h"
+
+/**
+ * Benchmark of the RPN evaluator: compares instruction counts and
+ * evaluation time for unfused, fused, and optimized then fused programs
+ * over the expressions in a postfix input file (input.txt by default).
+ *
+ * Usage: BenchRPN [file [repetitions]]
+ */
+int main(int argc, char *argv[]) {
+  using namespace std;
+  using namespace std::chrono;
+
+  const char *fileName = argc > 1 ? argv[1] : "input.txt";
+  long reps = argc > 2 ? atol(argv[2]) : 200000;
+
+  ifstream in(fileName);
+  if (!in) {
+    cerr << "Cannot open " << fileName << endl;
+    return EXIT_FAILURE;
+  }
+
+  // compile every expression in the file both ways
+  vector<Program> plain, fused, optimized;
+  Program program;
+  string token;
+  while (in >> token) {
+    if (token == "E") {
+      plain.push_back(program);
+      Program copy = program;
+      fuse(copy);
+      fused.push_back(copy);
+      optimize(program);
+      fuse(program);
+      optimized.push_back(program);
+      program.clear();
+    } else if (!compileToken(token, program)) {
+      cerr << "Bad token " << token << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  size_t plainOps = 0u, fusedOps = 0u, optimizedOps = 0u;
+  for (size_t i = 0u; i < plain.size(); i++) {
+    plainOps += plain[i].size();
+    fusedOps += fused[i].size();
+    optimizedOps += optimized[i].size();
+  }
+
+  cout << plain.size() << " expressions, " << reps << " repetitions" << endl;
+  cout << "unfused: " << plainOps << " instructions" << endl;
+  cout << "fused:   " << fusedOps << " instructions" << endl;
+  cout << "folded:  " << optimizedOps << " instructions" << endl;
+
+  Stack<double> stack;
+  const vector<Program> *sets[] = {&plain, &fused, &optimized};
+  const char *labels[] = {"unfused", "fused  ", "folded "};
+  double checksums[3] = {0.0, 0.0, 0.0};
+
+  for (int s = 0; s < 3; s++) {
+    const vector<Program> &programs = *sets[s];
+    steady_clock::time_point start = steady_clock::now();
+
+    for (long r = 0; r < reps; r++) {
+      for (size_t i = 0u; i < programs.size(); i++) {
+        checksums[s] += run(programs[i], stack);
+      }
+    }
+
+    double ns = duration<double, nano>(steady_clock::now() - start).count();
+    cout << labels[s] << ": "
+         << ns / (static_cast<double>(reps) * programs.size())
+         << " ns/expression" << endl;
+  }
+
+  if (checksums[0] != checksums[1] || checksums[0] != checksums[2]) {
+    cerr << "Optimized and unoptimized results differ" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
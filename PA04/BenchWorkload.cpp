@@ -0,0 +1,187 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Workload.h"
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Result of one run of the calculator.
+ */
+struct RunResult {
+  /** Wall-clock time, in seconds. */
+  double seconds;
+
+  /** Peak resident set size, in kilobytes. */
+  long maxRssKb;
+
+  /** False if the calculator couldn't be run or failed. */
+  bool ok;
+};
+
+/**
+ * Run the calculator as a separate process, as a user would, with its
+ * standard input and output redirected to files.
+ */
+static RunResult runCalculator(const string &calculator, const string &engine,
+                               const string &inName, const string &outName) {
+  RunResult result = {0.0, 0, false};
+  steady_clock::time_point start = steady_clock::now();
+
+  pid_t child = fork();
+  if (child == 0) {
+    int in = open(inName.c_str(), O_RDONLY);
+    int out = open(outName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (in < 0 || out < 0 || dup2(in, 0) < 0 || dup2(out, 1) < 0) {
+      _exit(127);
+    }
+    execl(calculator.c_str(), calculator.c_str(), "--engine", engine.c_str(),
+          static_cast<char *>(0));
+    _exit(127);
+  }
+
+  int status = 0;
+  rusage usage;
+  if (child < 0 || wait4(child, &status, 0, &usage) != child) {
+    return result;
+  }
+
+  result.seconds = duration<double>(steady_clock::now() - start).count();
+  result.maxRssKb = usage.ru_maxrss;
+  result.ok = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+  return result;
+}
+
+/**
+ * Get the reply lines, those starting ">>> ", of a file.
+ */
+static string replyLines(const string &fileName) {
+  ifstream in(fileName.c_str());
+  string line, replies;
+  while (getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.compare(0, 4, ">>> ") == 0) {
+      replies += line + "\n";
+    }
+  }
+  return replies;
+}
+
+/**
+ * End-to-end benchmark of the calculator program: generates workloads of
+ * several shapes, runs the calculator over each as a separate process,
+ * and reports expressions/s, tokens/s and peak RSS. First checks its
+ * replies on input.txt against output.txt and, for the double engine,
+ * on a small generated workload against the generator's expected
+ * replies.
+ *
+ * Options are applied to every workload, after its own shape, e.g.,
+ * "expressions=1000000" or "formats=i"; see parseWorkloadOption().
+ *
+ * Usage: BenchWorkload [calculator=./assgn04] [engine=double]
+ *        [name=value ...]
+ */
+int main(int argc, char *argv[]) {
+  string calculator = "./assgn04", engine = "double";
+  vector<string> args;
+  WorkloadOptions check;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (arg.compare(0, 11, "calculator=") == 0) {
+      calculator = arg.substr(11);
+    } else if (arg.compare(0, 7, "engine=") == 0) {
+      engine = arg.substr(7);
+    } else if (parseWorkloadOption(arg, check)) {
+      args.push_back(arg);
+    } else {
+      cerr << "Usage: " << argv[0]
+           << " [calculator=./assgn04] [engine=double] [name=value ...]"
+           << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  string base = "/tmp/BenchWorkload." + to_string(getpid());
+  string inName = base + ".in", outName = base + ".out";
+  int failures = 0;
+
+  // the calculator's replies to input.txt
+  RunResult r = runCalculator(calculator, engine, "input.txt", outName);
+  if (!r.ok || replyLines(outName) != replyLines("output.txt")) {
+    cerr << "Replies to input.txt don't match output.txt" << endl;
+    failures++;
+  }
+
+  // and to a small generated workload, with some malformed expressions
+  if (engine == "double") {
+    WorkloadOptions small;
+    small.expressions = 2000;
+    small.malformedPercent = 10u;
+    ofstream in(inName.c_str());
+    ostringstream expected;
+    generateWorkload(small, in, &expected);
+    in.close();
+    r = runCalculator(calculator, engine, inName, outName);
+    if (!r.ok || replyLines(outName) != expected.str()) {
+      cerr << "Replies to a generated workload don't match" << endl;
+      failures++;
+    }
+  }
+
+  // the benchmark workloads
+  const char *names[] = {"short", "mixed", "long", "deep", "malformed"};
+  const char *shapes[][2] = {{"operands=2-3", "depth=2"},
+                             {"operands=2-8", "depth=4"},
+                             {"operands=50-100", "depth=8"},
+                             {"operands=20-40", "depth=20"},
+                             {"operands=2-8", "malformed=25"}};
+
+  cout << calculator << " --engine " << engine << endl;
+  cout << "workload   expressions     tokens    expr/s   tokens/s"
+       << "   peak RSS" << endl;
+
+  for (int w = 0; w < 5 && failures == 0; w++) {
+    WorkloadOptions options;
+    options.expressions = 200000;
+    parseWorkloadOption(shapes[w][0], options);
+    parseWorkloadOption(shapes[w][1], options);
+    for (size_t i = 0u; i < args.size(); i++) {
+      parseWorkloadOption(args[i], options);
+    }
+
+    ofstream in(inName.c_str());
+    long tokens = generateWorkload(options, in, 0);
+    in.close();
+
+    r = runCalculator(calculator, engine, inName, "/dev/null");
+    if (!r.ok) {
+      cerr << "Cannot run " << calculator << endl;
+      failures++;
+      break;
+    }
+
+    char line[128];
+    snprintf(line, sizeof(line), "%-9s  %11ld  %9ld  %8.0f  %9.0f  %6ld KB",
+             names[w], options.expressions, tokens,
+             options.expressions / r.seconds, tokens / r.seconds,
+             r.maxRssKb);
+    cout << line << endl;
+  }
+
+  unlink(inName.c_str());
+  unlink(outName.c_str());
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
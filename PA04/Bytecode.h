@@ -0,0 +1,408 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Profile.h"
+#include "RPN.h"
+#include "Stack.h"
+
+//-----------------------------------------------------------
+// instruction set
+//-----------------------------------------------------------
+
+/**
+ * Operation codes for compiled postfix programs. The stack is written
+ * [... a b c] with c on top; "imm" is the instruction's first immediate
+ * and "imm2" its second.
+ */
+enum OpCode {
+  /** Push imm. */
+  OP_PUSH,
+  /** Push parameter number imm, e.g., from the token $0. */
+  OP_LOAD,
+  /** [... a b] -> [... a + b] */
+  OP_ADD,
+  /** [... a b] -> [... a - b] */
+  OP_SUB,
+  /** [... a b] -> [... a * b] */
+  OP_MUL,
+  /** [... a b] -> [... a / b] */
+  OP_DIV,
+  /** [... a] -> [... a + imm], fused from PUSH imm, ADD. */
+  OP_ADD_IMM,
+  /** [... a] -> [... a - imm], fused from PUSH imm, SUB. */
+  OP_SUB_IMM,
+  /** [... a] -> [... a * imm], fused from PUSH imm, MUL. */
+  OP_MUL_IMM,
+  /** [... a] -> [... a / imm], fused from PUSH imm, DIV. */
+  OP_DIV_IMM,
+  /** [... a b c] -> [... a + b * c], fused from MUL, ADD. */
+  OP_MUL_ADD,
+  /** [... a b c] -> [... a * (b + c)], fused from ADD, MUL. */
+  OP_ADD_MUL,
+  /** [... a] -> [... a * imm + imm2], fused from MUL_IMM, ADD_IMM. */
+  OP_MUL_ADD_IMM,
+  /** [... a] -> [... (a + imm) * imm2], fused from ADD_IMM, MUL_IMM. */
+  OP_ADD_MUL_IMM,
+  /** Number of operation codes. */
+  OP_COUNT
+};
+
+/**
+ * One instruction of a compiled postfix program, with its immediates in
+ * the number type the program is run in.
+ */
+template <class Num> struct BasicInstruction {
+  /** Operation to perform. */
+  OpCode op;
+
+  /** First immediate operand, for PUSH and the *_IMM operations. */
+  Num imm;
+
+  /** Second immediate operand, for the two-immediate operations. */
+  Num imm2;
+};
+
+/**
+ * Instruction as compiled, with double immediates.
+ */
+typedef BasicInstruction<double> Instruction;
+
+/**
+ * A compiled postfix expression: the instructions for one "E"-terminated
+ * expression, in execution order. Expressions may contain parameters,
+ * $0, $1, ..., so that one compiled template can be run many times with
+ * different values.
+ */
+typedef std::vector<Instruction> Program;
+
+/**
+ * A program converted to run in another number type; see
+ * convertProgram().
+ */
+template <class Num> using BasicProgram = std::vector<BasicInstruction<Num> >;
+
+/**
+ * Result of checking a program before running it; see checkDepth().
+ */
+enum RunStatus {
+  /** The program runs without stack errors. */
+  RUN_OK,
+  /** An instruction, or the end, finds too few operands. */
+  RUN_UNDERFLOW,
+  /** More than one value is left at the end. */
+  RUN_LEFTOVER,
+  /** A parameter has no value. */
+  RUN_UNBOUND
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/**
+ * Get a printable name for an operation code.
+ *
+ * \param op Operation code.
+ *
+ * \return Name of the operation, e.g., "MUL_ADD".
+ */
+inline const char *opName(OpCode op) {
+  static const char *names[OP_COUNT] = {
+      "PUSH",    "LOAD",    "ADD",     "SUB",        "MUL",       "DIV",
+      "ADD_IMM", "SUB_IMM", "MUL_IMM",    "DIV_IMM",   "MUL_ADD",
+      "ADD_MUL", "MUL_ADD_IMM", "ADD_MUL_IMM"};
+
+  return op < OP_COUNT ? names[op] : "?";
+}
+
+/**
+ * Get the operation code for an operator character.
+ *
+ * \param c One of +, -, * or /.
+ *
+ * \return Matching binary operation code.
+ */
+inline OpCode binaryOpCode(char c) {
+  switch (c) {
+  case '+':
+    return OP_ADD;
+  case '-':
+    return OP_SUB;
+  case '*':
+    return OP_MUL;
+  default:
+    return OP_DIV;
+  }
+}
+
+/**
+ * Compile one number, parameter or operator token, appending its
+ * instruction to a program. The "E" token is not compiled; it marks
+ * where the caller should run the program.
+ *
+ * \param token Token to compile.
+ *
+ * \param program Program to append to.
+ *
+ * \return true if the token was compiled, false if it is not a number,
+ * parameter or operator.
+ */
+inline bool compileToken(const std::string &token, Program &program) {
+  const char *first = token.c_str();
+  Instruction ins = {OP_PUSH, 0.0, 0.0};
+
+  if (isOperatorToken(first, first + token.size())) {
+    ins.op = binaryOpCode(*first);
+  } else if (token.size() > 1u && token[0] == '$') {
+    ins.op = OP_LOAD;
+    for (std::size_t i = 1u; i < token.size(); i++) {
+      if (token[i] < '0' || token[i] > '9' || i > 6u) {
+        return false;
+      }
+      ins.imm = ins.imm * 10.0 + (token[i] - '0');
+    }
+  } else if (!parseNumber(token, ins.imm)) {
+    return false;
+  }
+
+  program.push_back(ins);
+  return true;
+}
+
+/**
+ * Peephole pass that rewrites a program into superinstructions. Each
+ * rewrite performs the same IEEE operations in the same order as the
+ * instructions it replaces, so results are unchanged; in particular
+ * MUL_ADD rounds the product before adding, as the separate MUL, ADD
+ * would, rather than using a single-rounding fma.
+ *
+ * Operand-operator pairs (PUSH imm, op) become immediate-operand ops,
+ * which update the top of the stack in place instead of a push and two
+ * pops, and common operator pairs become one dispatch.
+ *
+ * \param program Program to rewrite in place.
+ */
+inline void fuse(Program &program) {
+  std::size_t out = 0u;
+
+  for (std::size_t i = 0u; i < program.size(); i++) {
+    Instruction ins = program[i];
+
+    // PUSH imm followed by a binary operator
+    if (out > 0u && program[out - 1u].op == OP_PUSH &&
+        ins.op >= OP_ADD && ins.op <= OP_DIV) {
+      out--;
+      ins.imm = program[out].imm;
+      ins.op = static_cast<OpCode>(ins.op - OP_ADD + OP_ADD_IMM);
+    }
+
+    // operator pairs
+    if (out > 0u) {
+      Instruction &prev = program[out - 1u];
+
+      if (prev.op == OP_MUL && ins.op == OP_ADD) {
+        prev.op = OP_MUL_ADD;
+        continue;
+      } else if (prev.op == OP_ADD && ins.op == OP_MUL) {
+        prev.op = OP_ADD_MUL;
+        continue;
+      } else if (prev.op == OP_MUL_IMM && ins.op == OP_ADD_IMM) {
+        prev.op = OP_MUL_ADD_IMM;
+        prev.imm2 = ins.imm;
+        continue;
+      } else if (prev.op == OP_ADD_IMM && ins.op == OP_MUL_IMM) {
+        prev.op = OP_ADD_MUL_IMM;
+        prev.imm2 = ins.imm;
+        continue;
+      }
+    }
+
+    program[out++] = ins;
+  }
+
+  program.resize(out);
+}
+
+/**
+ * Convert a program to run in another number type, rounding each
+ * immediate to that type once here rather than on every run.
+ *
+ * \param program Program to convert.
+ *
+ * \param converted Program to replace with the converted one; reused
+ * between calls to avoid reallocating it.
+ */
+template <class Num>
+void convertProgram(const Program &program, BasicProgram<Num> &converted) {
+  converted.resize(program.size());
+  for (std::size_t i = 0u; i < program.size(); i++) {
+    converted[i].op = program[i].op;
+    converted[i].imm = static_cast<Num>(program[i].imm);
+    converted[i].imm2 = static_cast<Num>(program[i].imm2);
+  }
+}
+
+/**
+ * Get the error message for a run status.
+ *
+ * \param status Status from checkDepth().
+ *
+ * \return Message, e.g., "Leftover operands in run()"; empty for
+ * RUN_OK.
+ */
+inline const char *runStatusMessage(RunStatus status) {
+  switch (status) {
+  case RUN_UNDERFLOW:
+    return "Too few operands in run()";
+  case RUN_LEFTOVER:
+    return "Leftover operands in run()";
+  case RUN_UNBOUND:
+    return "Unbound parameter in run()";
+  default:
+    return "";
+  }
+}
+
+/**
+ * Check in one pass, without running it, that a program, fused or not,
+ * never pops an empty stack, binds every parameter and leaves exactly
+ * one value; if so, run() on an empty stack can't fail. Malformed input
+ * is rejected here with a status rather than by run() throwing, which
+ * costs far more per bad expression.
+ *
+ * \param program Program to check.
+ *
+ * \param nArgs Number of parameter values run() will be given.
+ *
+ * \return RUN_OK, or the first error run() would have reported.
+ */
+inline RunStatus checkDepth(const Program &program, std::size_t nArgs = 0u) {
+  // operands each operation takes; every one leaves a single value
+  static const unsigned char needs[OP_COUNT] = {0, 0, 2, 2, 2, 2, 1,
+                                                1, 1, 1, 3, 3, 1, 1};
+  std::size_t depth = 0u;
+
+  for (std::size_t i = 0u; i < program.size(); i++) {
+    const Instruction &ins = program[i];
+    if (ins.op >= OP_COUNT || depth < needs[ins.op]) {
+      // a bad opcode is treated as needing more than there is
+      return RUN_UNDERFLOW;
+    }
+    if (ins.op == OP_LOAD && ins.imm >= nArgs) {
+      return RUN_UNBOUND;
+    }
+    depth = depth - needs[ins.op] + 1u;
+  }
+
+  if (depth == 0u) {
+    return RUN_UNDERFLOW;
+  }
+  return depth == 1u ? RUN_OK : RUN_LEFTOVER;
+}
+
+/**
+ * Run a compiled program, leaving the stack empty. All arithmetic is
+ * done in the program's number type, e.g., double for a Program as
+ * compiled, or Fixed for one converted with convertProgram().
+ *
+ * \param program Program to run.
+ *
+ * \param stack Operand stack; normally empty on entry, and reused
+ * between runs to avoid reallocating it. A Checked stack makes a
+ * malformed program throw; an Unchecked one drops the emptiness test
+ * from every pop and peek, so the program must have passed
+ * checkDepth() first.
+ *
+ * \param args Values of the parameters $0, $1, ..., if any.
+ *
+ * \param nArgs Number of values in args.
+ *
+ * \return Value of the expression.
+ *
+ * \throws std::out_of_range if an instruction finds too few operands, or
+ * a parameter has no value.
+ *
+ * \throws std::invalid_argument if operands are left over at the end.
+ */
+template <class Num, class Check>
+Num run(const BasicProgram<Num> &program, Stack<Num, Check> &stack,
+        const Num *args = 0, std::size_t nArgs = 0u) {
+  const BasicInstruction<Num> *ip = program.data();
+  const BasicInstruction<Num> *end = ip + program.size();
+
+  for (; ip != end; ++ip) {
+    RPN_PROFILE_OP(ip->op, opName(ip->op));
+    Num rhs, mid;
+    std::size_t index;
+
+    switch (ip->op) {
+    case OP_PUSH:
+      stack.push(ip->imm);
+      break;
+    case OP_LOAD:
+      // parameter numbers are small integers, exact in every type
+      index = static_cast<std::size_t>(static_cast<double>(ip->imm));
+      if (index >= nArgs) {
+        throw std::out_of_range("Unbound parameter in run()");
+      }
+      stack.push(args[index]);
+      break;
+    case OP_ADD:
+      rhs = stack.pop();
+      stack.peek() = stack.peek() + rhs;
+      break;
+    case OP_SUB:
+      rhs = stack.pop();
+      stack.peek() = stack.peek() - rhs;
+      break;
+    case OP_MUL:
+      rhs = stack.pop();
+      stack.peek() = stack.peek() * rhs;
+      break;
+    case OP_DIV:
+      rhs = stack.pop();
+      stack.peek() = stack.peek() / rhs;
+      break;
+    case OP_ADD_IMM:
+      stack.peek() = stack.peek() + ip->imm;
+      break;
+    case OP_SUB_IMM:
+      stack.peek() = stack.peek() - ip->imm;
+      break;
+    case OP_MUL_IMM:
+      stack.peek() = stack.peek() * ip->imm;
+      break;
+    case OP_DIV_IMM:
+      stack.peek() = stack.peek() / ip->imm;
+      break;
+    case OP_MUL_ADD:
+      rhs = stack.pop();
+      mid = stack.pop();
+      stack.peek() = stack.peek() + mid * rhs;
+      break;
+    case OP_ADD_MUL:
+      rhs = stack.pop();
+      mid = stack.pop();
+      stack.peek() = stack.peek() * (mid + rhs);
+      break;
+    case OP_MUL_ADD_IMM:
+      stack.peek() = stack.peek() * ip->imm + ip->imm2;
+      break;
+    case OP_ADD_MUL_IMM:
+      stack.peek() = (stack.peek() + ip->imm) * ip->imm2;
+      break;
+    default:
+      throw std::invalid_argument("Bad opcode in run()");
+    }
+  }
+
+  Num result = stack.pop();
+  if (!stack.isEmpty()) {
+    throw std::invalid_argument("Leftover operands in run()");
+  }
+
+  return result;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cassert>
+#include <stdexcept>
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/*
+ * Checking policies for DLL, Stack and Queue. Each container takes one
+ * as its last template parameter and calls Check::require(ok, what)
+ * before every operation that needs a non-empty list, an index in
+ * range or an iterator that is not at the end, e.g.,
+ *
+ *   Stack<double> checked;             // throws std::out_of_range
+ *   Stack<double, Unchecked> fast;     // no checks at all
+ *
+ * The conditions passed to require() have no side effects, so with
+ * Unchecked, or with DebugAssert and NDEBUG, the compiler drops them
+ * along with the exception paths.
+ */
+
+/**
+ * Default policy: a failed check throws std::out_of_range.
+ */
+struct Checked {
+  static void require(bool ok, const char *what) {
+    if (!ok) {
+      throw std::out_of_range(what);
+    }
+  }
+};
+
+/**
+ * Debug policy: a failed check is an assert() failure, so checks are
+ * made in debug builds and compiled out when NDEBUG is defined.
+ */
+struct DebugAssert {
+  static void require(bool ok, const char *what) {
+    assert(ok && what);
+    (void)ok;
+    (void)what;
+  }
+};
+
+/**
+ * Release policy: no checks. Popping an empty stack, dereferencing an
+ * end iterator and the like are undefined behavior, so only use it
+ * where the caller already guarantees those cannot happen.
+ */
+struct Unchecked {
+  static void require(bool, const char *) {}
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Progress of a calculator run over an input file, saved between
+ * expressions so that a run which dies can resume where it was instead
+ * of starting over. Between expressions a session holds no state, so
+ * the offsets are all a resumed run needs.
+ */
+struct Checkpoint {
+  /**
+   * Constructor. Make the checkpoint of a run that hasn't started.
+   */
+  Checkpoint() : inputOffset(0u), expressions(0u), outputOffset(0u) {}
+
+  /** Byte offset in the input just past the last expression completed. */
+  std::uint64_t inputOffset;
+
+  /** Number of expressions completed, "E"s or infix lines. */
+  std::uint64_t expressions;
+
+  /** Byte offset in the output just past the last reply written. */
+  std::uint64_t outputOffset;
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/**
+ * Read a checkpoint file written by writeCheckpoint().
+ *
+ * \param path Name of the checkpoint file.
+ *
+ * \param checkpoint Set to the checkpoint, if it could be read.
+ *
+ * \return false if the file is missing or malformed.
+ */
+inline bool readCheckpoint(const std::string &path, Checkpoint &checkpoint) {
+  std::ifstream in(path.c_str());
+  std::string magic;
+  Checkpoint read;
+
+  if (!(in >> magic >> read.inputOffset >> read.expressions >>
+        read.outputOffset) ||
+      magic != "rpn-checkpoint") {
+    return false;
+  }
+  checkpoint = read;
+  return true;
+}
+
+/**
+ * Write a checkpoint file, one line of text. It is written beside the
+ * file and renamed over it, so a run killed while writing leaves the
+ * previous checkpoint whole.
+ *
+ * \param path Name of the checkpoint file.
+ *
+ * \param checkpoint Checkpoint to write.
+ *
+ * \return false if the file couldn't be written.
+ */
+inline bool writeCheckpoint(const std::string &path,
+                            const Checkpoint &checkpoint) {
+  std::string temporary = path + ".tmp";
+  std::ofstream out(temporary.c_str(), std::ios::trunc);
+
+  out << "rpn-checkpoint " << checkpoint.inputOffset << ' '
+      << checkpoint.expressions << ' ' << checkpoint.outputOffset << '\n';
+  out.close();
+  return !out.fail() && std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * Count a completed expression and, every given number of them, save a
+ * checkpoint of where the streams are. The output is flushed first, so
+ * a checkpoint never covers replies that weren't written.
+ *
+ * \param path Name of the checkpoint file.
+ *
+ * \param every Number of expressions between checkpoints.
+ *
+ * \param in Input stream, just past the expression.
+ *
+ * \param out Output stream, just past its reply.
+ *
+ * \param checkpoint Progress so far, updated.
+ *
+ * \return false if a checkpoint was due and couldn't be saved.
+ */
+inline bool advanceCheckpoint(const std::string &path, std::uint64_t every,
+                              std::istream &in, std::ostream &out,
+                              Checkpoint &checkpoint) {
+  checkpoint.expressions++;
+  if (checkpoint.expressions % every != 0u) {
+    return true;
+  }
+
+  // at the end of the input there is nothing left to resume
+  std::streamoff inputOffset = in.tellg();
+  if (inputOffset < 0) {
+    in.clear(in.rdstate() & ~std::ios::failbit);
+    return true;
+  }
+  out.flush();
+  checkpoint.inputOffset = static_cast<std::uint64_t>(inputOffset);
+  checkpoint.outputOffset = static_cast<std::uint64_t>(
+      static_cast<std::streamoff>(out.tellp()));
+  return writeCheckpoint(path, checkpoint);
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a signed fixed-point number with 32 integer and
+ * 32 fractional bits, stored in a 64-bit integer. All arithmetic is
+ * integer arithmetic with fixed rounding rules, so results are
+ * bit-identical on every machine and compiler, unlike floating point
+ * with its varying contraction, excess precision and library rounding.
+ *
+ * Overflow saturates at the largest or smallest value, as does division
+ * by zero (0 / 0 gives 0); multiplication rounds to nearest, ties up,
+ * and division truncates toward zero. The range is about +/-2.1e9 with
+ * a resolution of about 2.3e-10.
+ *
+ * Needs a compiler with __int128, e.g., GCC or Clang on 64-bit targets.
+ */
+class Fixed {
+public:
+  /** Number of fractional bits. */
+  static const int fractionBits = 32;
+
+  /**
+   * Default constructor. Make zero.
+   */
+  Fixed() : raw(0) {}
+
+  /**
+   * Conversion from double, rounding to the nearest representable
+   * value; out of range values saturate and NaN becomes zero.
+   *
+   * \param d Value to convert.
+   */
+  explicit Fixed(double d);
+
+  /**
+   * Make a number from its raw representation.
+   *
+   * \param bits Value times 2^fractionBits.
+   *
+   * \return Number with that representation.
+   */
+  static Fixed fromRaw(std::int64_t bits) {
+    Fixed f;
+    f.raw = bits;
+    return f;
+  }
+
+  /**
+   * Get the raw representation.
+   *
+   * \return Value times 2^fractionBits.
+   */
+  std::int64_t bits() const { return raw; }
+
+  /**
+   * Conversion to double, exact unless more than 53 significant bits
+   * are in use.
+   */
+  explicit operator double() const {
+    return std::ldexp(static_cast<double>(raw), -fractionBits);
+  }
+
+  /** Saturating addition. */
+  friend Fixed operator+(Fixed a, Fixed b) {
+    std::int64_t r;
+    if (__builtin_add_overflow(a.raw, b.raw, &r)) {
+      return saturated(b.raw > 0);
+    }
+    return fromRaw(r);
+  }
+
+  /** Saturating subtraction. */
+  friend Fixed operator-(Fixed a, Fixed b) {
+    std::int64_t r;
+    if (__builtin_sub_overflow(a.raw, b.raw, &r)) {
+      return saturated(b.raw < 0);
+    }
+    return fromRaw(r);
+  }
+
+  /** Saturating multiplication, rounding to nearest, ties up. */
+  friend Fixed operator*(Fixed a, Fixed b) {
+    __int128 p = static_cast<__int128>(a.raw) * b.raw;
+    return clamp((p + (static_cast<__int128>(1) << (fractionBits - 1))) >>
+                 fractionBits);
+  }
+
+  /** Saturating division, truncating toward zero. */
+  friend Fixed operator/(Fixed a, Fixed b) {
+    if (b.raw == 0) {
+      return a.raw == 0 ? Fixed() : saturated(a.raw > 0);
+    }
+    __int128 scale = static_cast<__int128>(1) << fractionBits;
+    return clamp(static_cast<__int128>(a.raw) * scale / b.raw);
+  }
+
+  /** Equality operator. */
+  friend bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+
+  /** Inequality operator. */
+  friend bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+
+private:
+  /** Value times 2^fractionBits. */
+  std::int64_t raw;
+
+  /**
+   * Get the largest value if positive, otherwise the smallest.
+   */
+  static Fixed saturated(bool positive) {
+    return fromRaw(positive ? std::numeric_limits<std::int64_t>::max()
+                            : std::numeric_limits<std::int64_t>::min());
+  }
+
+  /**
+   * Make a number from a wide raw value, saturating.
+   */
+  static Fixed clamp(__int128 r) {
+    if (r > std::numeric_limits<std::int64_t>::max()) {
+      return saturated(true);
+    }
+    if (r < std::numeric_limits<std::int64_t>::min()) {
+      return saturated(false);
+    }
+    return fromRaw(static_cast<std::int64_t>(r));
+  }
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the conversion from double. Scaling by a power of
+ * two is exact, and llround rounds halfway cases away from zero
+ * whatever the rounding mode, so the result depends only on d.
+ */
+inline Fixed::Fixed(double d) : raw(0) {
+  double scaled = std::ldexp(d, fractionBits);
+
+  if (std::isnan(scaled)) {
+    raw = 0;
+  } else if (scaled >= 9223372036854775808.0) {
+    raw = std::numeric_limits<std::int64_t>::max();
+  } else if (scaled <= -9223372036854775808.0) {
+    raw = std::numeric_limits<std::int64_t>::min();
+  } else {
+    raw = std::llround(scaled);
+  }
+}
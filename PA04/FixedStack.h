@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a templated stack with a fixed capacity of N
+ * elements, stored in an in-place array. Unlike Stack, it never
+ * allocates, and every operation is constexpr, so a FixedStack can
+ * be used inside constant expressions evaluated by the compiler.
+ */
+template <class T, std::size_t N> class FixedStack {
+public:
+  /**
+   * Default constructor. Make a new, empty stack.
+   */
+  constexpr FixedStack() : data(), n(0u) {}
+
+  /**
+   * Get the maximum number of elements the stack can hold.
+   *
+   * \return Capacity of the stack, N.
+   */
+  constexpr std::size_t capacity() const { return N; }
+
+  /**
+   * Remove all elements from this stack.
+   */
+  constexpr void clear() { n = 0u; }
+
+  /**
+   * Determine if the stack is empty.
+   *
+   * \return True if the stack is empty, false if it has elements.
+   */
+  constexpr bool isEmpty() const { return n == 0u; }
+
+  /**
+   * Determine if the stack is full.
+   *
+   * \return True if no more elements can be pushed, false otherwise.
+   */
+  constexpr bool isFull() const { return n == N; }
+
+  /**
+   * Get a reference to the top element on the stack, without removing
+   * it.
+   *
+   * \return Reference to the element at the top of the stack.
+   */
+  constexpr const T &peek() const;
+
+  /**
+   * Pop the top element from the stack.
+   *
+   * \return Element of type T that was at the top of the stack.
+   */
+  constexpr T pop();
+
+  /**
+   * Push a new item onto the stack.
+   *
+   * \param a Element of type T to push onto the stack.
+   */
+  constexpr void push(const T &a);
+
+  /**
+   * Get the number of elements in the stack.
+   *
+   * \return Number of elements in the stack.
+   */
+  constexpr std::size_t size() const { return n; }
+
+  /**
+   * Override of the stream insertion operator for FixedStack objects.
+   * Elements are printed top first, like Stack.
+   *
+   * \param out ostream object to output to, e.g., cout
+   *
+   * \param stack FixedStack to output
+   *
+   * \return the out ostream object
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const FixedStack<T, N> &stack) {
+    out << "[";
+
+    for (std::size_t i = stack.n; i > 0u; i--) {
+      out << stack.data[i - 1u];
+
+      if (i > 1u) {
+        out << ", ";
+      }
+    }
+
+    out << "]";
+
+    return out;
+  }
+
+private:
+  /** In-place storage for the elements; data[n - 1] is the top. */
+  T data[N];
+
+  /** Number of elements currently on the stack. */
+  std::size_t n;
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Peek function implementation.
+ */
+template <class T, std::size_t N>
+constexpr const T &FixedStack<T, N>::peek() const {
+  if (n == 0u) {
+    throw std::out_of_range("Empty stack in FixedStack::peek()");
+  }
+  return data[n - 1u];
+}
+
+/*
+ * Pop function implementation.
+ */
+template <class T, std::size_t N> constexpr T FixedStack<T, N>::pop() {
+  if (n == 0u) {
+    throw std::out_of_range("Empty stack in FixedStack::pop()");
+  }
+  n--;
+  return data[n];
+}
+
+/*
+ * Push function implementation.
+ */
+template <class T, std::size_t N>
+constexpr void FixedStack<T, N>::push(const T &a) {
+  if (n == N) {
+    throw std::out_of_range("Full stack in FixedStack::push()");
+  }
+  data[n] = a;
+  n++;
+}
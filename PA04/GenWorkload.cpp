@@ -0,0 +1,47 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "Workload.h"
+
+/**
+ * Write a generated calculator workload to standard output; see
+ * generateWorkload(). With "expected=file" the replies the calculator
+ * should give are written to that file.
+ *
+ * Usage: GenWorkload [name=value ...] > file
+ */
+int main(int argc, char *argv[]) {
+  using namespace std;
+
+  WorkloadOptions options;
+  string expectedName;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (arg.compare(0, 9, "expected=") == 0) {
+      expectedName = arg.substr(9);
+    } else if (!parseWorkloadOption(arg, options)) {
+      cerr << "Usage: " << argv[0]
+           << " [expressions=N] [seed=N] [operands=MIN-MAX] [depth=N]"
+           << endl
+           << "  [operators=+-*/] [formats=idse] [malformed=PERCENT]"
+           << " [expected=file]" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  ofstream expected;
+  if (!expectedName.empty()) {
+    expected.open(expectedName.c_str());
+    if (!expected) {
+      cerr << "Cannot write " << expectedName << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  ios::sync_with_stdio(false);
+  generateWorkload(options, cout, expectedName.empty() ? 0 : &expected);
+
+  return cout && (expectedName.empty() || expected) ? EXIT_SUCCESS
+                                                    : EXIT_FAILURE;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "Bytecode.h"
+#include "Queue.h"
+#include "Stack.h"
+
+//-----------------------------------------------------------
+// helper functions
+//-----------------------------------------------------------
+
+/**
+ * Get the binding strength of an operator on the infix compiler's
+ * operator stack: 'n' is unary minus, which binds tightest.
+ *
+ * \param op One of +, -, *, / or n.
+ *
+ * \return Precedence; higher binds tighter.
+ */
+inline int infixPrecedence(char op) {
+  switch (op) {
+  case '+':
+  case '-':
+    return 1;
+  case '*':
+  case '/':
+    return 2;
+  default:
+    return 3;
+  }
+}
+
+/**
+ * Append the instructions for an operator from the operator stack to
+ * the output queue. Unary minus becomes a multiplication by -1, since
+ * postfix has no negation for it to match. That flips the sign of every
+ * number, zeros included, but it isn't IEEE negation for NaN: x86
+ * returns the NaN operand, sign and all, so -(0/0) prints as 0/0 does.
+ *
+ * \param op One of +, -, *, / or n.
+ *
+ * \param output Output queue.
+ */
+inline void emitInfixOperator(char op, Queue<Instruction> &output) {
+  if (op == 'n') {
+    Instruction minusOne = {OP_PUSH, -1.0, 0.0};
+    output.enqueue(minusOne);
+    op = '*';
+  }
+  Instruction ins = {binaryOpCode(op), 0.0, 0.0};
+  output.enqueue(ins);
+}
+
+/**
+ * Find the end of the operand starting at a position in an infix
+ * expression: a parameter such as $0, or a number with an optional
+ * sign, fraction and exponent, e.g., -1.5e3.
+ *
+ * \param text Infix expression.
+ *
+ * \param i Position of the operand.
+ *
+ * \return Position one past its last character; i if there is none.
+ */
+inline std::size_t scanInfixOperand(const std::string &text, std::size_t i) {
+  std::size_t n = text.size();
+
+  if (i < n && text[i] == '$') {
+    for (i++; i < n && text[i] >= '0' && text[i] <= '9'; i++) {
+    }
+    return i;
+  }
+
+  std::size_t start = i;
+  if (i < n && (text[i] == '+' || text[i] == '-')) {
+    i++;
+  }
+  std::size_t digits = i;
+  while (i < n && ((text[i] >= '0' && text[i] <= '9') || text[i] == '.')) {
+    i++;
+  }
+  if (i == digits) {
+    return start;
+  }
+
+  // an exponent only if digits follow, so "2e" is the number 2 then e
+  if (i < n && (text[i] == 'e' || text[i] == 'E')) {
+    std::size_t j = i + 1u;
+    if (j < n && (text[j] == '+' || text[j] == '-')) {
+      j++;
+    }
+    if (j < n && text[j] >= '0' && text[j] <= '9') {
+      for (i = j; i < n && text[i] >= '0' && text[i] <= '9'; i++) {
+      }
+    }
+  }
+  return i;
+}
+
+//-----------------------------------------------------------
+// infix compiler
+//-----------------------------------------------------------
+
+/**
+ * Compile an infix expression, e.g., "2 * ($0 + 1.5) - -3 / 4", into a
+ * program in one pass with the shunting-yard algorithm: operands go
+ * straight to an output queue, and operators wait on a stack until one
+ * that binds less tightly arrives. There is no intermediate postfix
+ * text to print and parse again.
+ *
+ * The binary operators are +, -, * and /, with * and / binding tighter
+ * and all of them left-associative, so 8 - 3 - 2 is 3. Parentheses
+ * group, and + or - before an operand is a sign: part of the number
+ * for a literal, otherwise unary minus (plus does nothing). Operands
+ * are the calculator's number and parameter tokens. Whitespace between
+ * tokens is optional.
+ *
+ * The program is the same the postfix form would compile to, e.g.,
+ * "(3 + 4) * 2" gives the program of "3 4 + 2 *", and is always well
+ * formed: checkDepth() accepts it if its parameters are bound.
+ *
+ * \param text Infix expression.
+ *
+ * \param program Set to the compiled program; its contents are replaced.
+ *
+ * \param error Set to a description of the first error, if any, e.g.,
+ * "Unmatched ) at column 7".
+ *
+ * \return true if the expression compiled, false on a syntax error.
+ */
+inline bool compileInfix(const std::string &text, Program &program,
+                         std::string &error) {
+  Stack<char> operators;
+  Queue<Instruction> output;
+  Program operand;
+  std::string token;
+  bool expectOperand = true;
+  std::size_t i = 0u, n = text.size();
+
+  program.clear();
+  error.clear();
+
+  while (true) {
+    while (i < n && (text[i] == ' ' || text[i] == '\t' || text[i] == '\r' ||
+                     text[i] == '\n' || text[i] == '\f' || text[i] == '\v')) {
+      i++;
+    }
+    if (i == n) {
+      break;
+    }
+    char c = text[i];
+
+    if (expectOperand) {
+      std::size_t end = scanInfixOperand(text, i);
+      if (c == '(') {
+        operators.push('(');
+        i++;
+      } else if ((c == '-' || c == '+') && end == i) {
+        // a sign before something other than a number
+        if (c == '-') {
+          operators.push('n');
+        }
+        i++;
+      } else if (end > i && compileToken(token.assign(text, i, end - i),
+                                         operand)) {
+        output.enqueue(operand.back());
+        operand.clear();
+        expectOperand = false;
+        i = end;
+      } else {
+        error = (end > i ? "Bad operand " + text.substr(i, end - i)
+                         : std::string("Missing operand")) +
+                " at column " + std::to_string(i + 1u);
+        return false;
+      }
+    } else if (c == ')') {
+      while (!operators.isEmpty() && operators.peek() != '(') {
+        emitInfixOperator(operators.pop(), output);
+      }
+      if (operators.isEmpty()) {
+        error = "Unmatched ) at column " + std::to_string(i + 1u);
+        return false;
+      }
+      operators.pop();
+      i++;
+    } else if (c == '+' || c == '-' || c == '*' || c == '/') {
+      // pop what binds at least as tightly, for left associativity
+      while (!operators.isEmpty() && operators.peek() != '(' &&
+             infixPrecedence(operators.peek()) >= infixPrecedence(c)) {
+        emitInfixOperator(operators.pop(), output);
+      }
+      operators.push(c);
+      expectOperand = true;
+      i++;
+    } else {
+      error = std::string("Unexpected ") + c + " at column " +
+              std::to_string(i + 1u);
+      return false;
+    }
+  }
+
+  if (expectOperand) {
+    error = "Missing operand at end";
+    return false;
+  }
+  while (!operators.isEmpty()) {
+    char op = operators.pop();
+    if (op == '(') {
+      error = "Unmatched (";
+      return false;
+    }
+    emitInfixOperator(op, output);
+  }
+
+  program.reserve(output.size());
+  while (!output.isEmpty()) {
+    program.push_back(output.dequeue());
+  }
+  return true;
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace std::chrono;
+
+/**
+ * Connect to the calculator server, retrying for a few seconds while it
+ * starts up.
+ *
+ * \return Socket, or -1 on failure.
+ */
+int connectTo(const string &path) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1u);
+
+  for (int attempt = 0; attempt < 100; attempt++) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 &&
+        connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+      return fd;
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+    this_thread::sleep_for(milliseconds(50));
+  }
+
+  return -1;
+}
+
+/**
+ * Results of one client connection.
+ */
+struct ClientStats {
+  /** Latency of each expression, in microseconds. */
+  vector<double> latencies;
+
+  /** Number of replies that were errors. */
+  long errors;
+
+  /** False if the connection failed. */
+  bool ok;
+};
+
+/**
+ * Send count expressions over one connection, in batches of depth sent
+ * without waiting for replies, and time each reply from the moment its
+ * batch was sent.
+ */
+void client(const string &path, const vector<string> &exprs, long count,
+            unsigned depth, ClientStats &stats) {
+  stats.errors = 0;
+  stats.ok = false;
+  stats.latencies.reserve(count);
+
+  int fd = connectTo(path);
+  if (fd < 0) {
+    return;
+  }
+
+  string batch;
+  vector<char> buffer(65536u);
+  size_t next = 0u;
+
+  for (long sent = 0; sent < count;) {
+    unsigned n = static_cast<unsigned>(min<long>(depth, count - sent));
+    batch.clear();
+    for (unsigned i = 0u; i < n; i++) {
+      batch += exprs[next];
+      batch += '\n';
+      next = (next + 1u) % exprs.size();
+    }
+
+    steady_clock::time_point t0 = steady_clock::now();
+    for (size_t done = 0u; done < batch.size();) {
+      ssize_t k = send(fd, batch.data() + done, batch.size() - done,
+                       MSG_NOSIGNAL);
+      if (k <= 0) {
+        close(fd);
+        return;
+      }
+      done += static_cast<size_t>(k);
+    }
+
+    // replies are one line each, in order
+    unsigned replies = 0u;
+    bool errorLine = false;
+    size_t column = 0u;
+    while (replies < n) {
+      ssize_t k = read(fd, buffer.data(), buffer.size());
+      if (k <= 0) {
+        close(fd);
+        return;
+      }
+      double us = duration<double, micro>(steady_clock::now() - t0).count();
+      for (ssize_t i = 0; i < k; i++) {
+        if (buffer[i] == '\n') {
+          stats.latencies.push_back(us);
+          stats.errors += errorLine;
+          replies++;
+          errorLine = false;
+          column = 0u;
+        } else {
+          // ">>> Error:" has its E at column 4
+          if (column == 4u && buffer[i] == 'E') {
+            errorLine = true;
+          }
+          column++;
+        }
+      }
+    }
+    sent += n;
+  }
+
+  close(fd);
+  stats.ok = true;
+}
+
+/**
+ * Load generator for the calculator server (assgn04 --serve): several
+ * connections each send the expressions from a postfix input file over
+ * and over, pipelined in batches, and the throughput and reply latency
+ * percentiles are reported.
+ *
+ * Usage: LoadClient socket [expressions [connections [depth [file]]]]
+ */
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    cerr << "Usage: " << argv[0]
+         << " socket [expressions [connections [depth [file]]]]" << endl;
+    return EXIT_FAILURE;
+  }
+
+  string path = argv[1];
+  long total = argc > 2 ? atol(argv[2]) : 400000;
+  unsigned connections = argc > 3 ? strtoul(argv[3], 0, 10) : 4u;
+  unsigned depth = argc > 4 ? strtoul(argv[4], 0, 10) : 64u;
+  const char *fileName = argc > 5 ? argv[5] : "input.txt";
+
+  // split the file into expressions, each ending with its "E"
+  ifstream in(fileName);
+  vector<string> exprs;
+  string token, expr;
+  while (in >> token) {
+    expr += expr.empty() ? token : " " + token;
+    if (token == "E") {
+      exprs.push_back(expr);
+      expr.clear();
+    }
+  }
+  if (exprs.empty()) {
+    cerr << "No expressions in " << fileName << endl;
+    return EXIT_FAILURE;
+  }
+  if (total <= 0 || connections == 0u || depth == 0u) {
+    cerr << "Expressions, connections and depth must be positive" << endl;
+    return EXIT_FAILURE;
+  }
+
+  vector<ClientStats> stats(connections);
+  vector<thread> threads;
+
+  // spread the remainder over the first connections, so that exactly
+  // total expressions are sent even with more connections than that
+  steady_clock::time_point start = steady_clock::now();
+  for (unsigned c = 0u; c < connections; c++) {
+    long each = total / connections + (c < total % connections ? 1 : 0);
+    threads.emplace_back(client, path, cref(exprs), each, depth,
+                         ref(stats[c]));
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  double seconds = duration<double>(steady_clock::now() - start).count();
+
+  vector<double> all;
+  long errors = 0;
+  for (const ClientStats &s : stats) {
+    if (!s.ok) {
+      cerr << "A connection to " << path << " failed" << endl;
+      return EXIT_FAILURE;
+    }
+    all.insert(all.end(), s.latencies.begin(), s.latencies.end());
+    errors += s.errors;
+  }
+  sort(all.begin(), all.end());
+
+  cout << all.size() << " expressions over " << connections
+       << " connections, " << depth << " per batch, " << errors << " errors"
+       << endl;
+  cout << "throughput: " << all.size() / seconds << " expressions/s" << endl;
+  cout << "latency:    p50 " << all[all.size() / 2u] << " us, p99 "
+       << all[all.size() * 99u / 100u] << " us, max " << all.back() << " us"
+       << endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include "Bytecode.h"
+#include "RPN.h"
+
+//-----------------------------------------------------------
+// helper functions
+//-----------------------------------------------------------
+
+/**
+ * Find where the subexpression producing the value on top of the stack
+ * just before program[end] begins, by walking back over stack effects.
+ * Only meaningful for unfused programs (PUSH, LOAD and the binary
+ * operators).
+ *
+ * \param program Program to search.
+ *
+ * \param end Index one past the last instruction of the subexpression.
+ *
+ * \param start Set to the index of the subexpression's first
+ * instruction.
+ *
+ * \return true if a complete subexpression was found, false otherwise.
+ */
+inline bool operandStart(const Program &program, std::size_t end,
+                         std::size_t &start) {
+  std::size_t need = 1u;
+
+  while (end > 0u) {
+    end--;
+    if (program[end].op == OP_PUSH || program[end].op == OP_LOAD) {
+      need--;
+    } else {
+      need++;
+    }
+    if (need == 0u) {
+      start = end;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Determine if an unfused program is well formed, i.e., no instruction
+ * underflows the stack and exactly one value is left at the end.
+ *
+ * \param program Program to check.
+ *
+ * \return true if the program is well formed, false otherwise.
+ */
+inline bool isWellFormed(const Program &program) {
+  std::size_t depth = 0u;
+
+  for (std::size_t i = 0u; i < program.size(); i++) {
+    if (program[i].op == OP_PUSH || program[i].op == OP_LOAD) {
+      depth++;
+    } else if (program[i].op >= OP_ADD && program[i].op <= OP_DIV &&
+               depth >= 2u) {
+      depth--;
+    } else {
+      return false;
+    }
+  }
+
+  return depth == 1u;
+}
+
+/**
+ * Determine if a value is +0.0 or -0.0 with the given sign.
+ */
+inline bool isZero(double d, bool negative) {
+  return d == 0.0 && std::signbit(d) == negative;
+}
+
+//-----------------------------------------------------------
+// optimizer
+//-----------------------------------------------------------
+
+/**
+ * Constant folding and algebraic simplification of an unfused program;
+ * run it after compiling and before fuse(). Constant expressions fold
+ * to a single PUSH; the identities matter for templates with
+ * parameters, which are optimized once and run many times. Only
+ * rewrites that give
+ * bit-identical IEEE results for every operand, including -0.0,
+ * infinities and NaN, are applied:
+ *
+ * - an operator on two constants is evaluated once, with the same
+ *   applyOperator the calculator uses;
+ * - x * 1, 1 * x, x / 1, x - 0 and x + -0, -0 + x become x (but not
+ *   x + 0, which turns -0 into +0, nor x * 0, which is not 0 for
+ *   infinities and NaN);
+ * - x - c becomes x + -c, which is the same IEEE operation and lets
+ *   fuse() combine it with multiplications;
+ * - x / c becomes x * (1 / c) when c is a power of two whose reciprocal
+ *   is exact, as both then round the same real quotient.
+ *
+ * Malformed programs are left untouched so that they fail exactly as
+ * they would have without optimization.
+ *
+ * \param program Program to optimize in place.
+ */
+inline void optimize(Program &program) {
+  if (!isWellFormed(program)) {
+    return;
+  }
+
+  std::size_t out = 0u;
+
+  for (std::size_t i = 0u; i < program.size(); i++) {
+    Instruction ins = program[i];
+
+    if (ins.op == OP_PUSH || ins.op == OP_LOAD) {
+      program[out++] = ins;
+      continue;
+    }
+
+    // the right operand occupies [right, out), the left [left, right)
+    std::size_t right = 0u, left = 0u;
+    operandStart(program, out, right);
+    operandStart(program, right, left);
+    Instruction &lhs = program[left];
+    Instruction &rhs = program[right];
+    bool lhsConst = right - left == 1u && lhs.op == OP_PUSH;
+    bool rhsConst = out - right == 1u && rhs.op == OP_PUSH;
+
+    if (lhsConst && rhsConst) {
+      // fold: both operands are single PUSHes
+      lhs.imm = applyOperator("+-*/"[ins.op - OP_ADD], lhs.imm, rhs.imm);
+      out = right;
+      continue;
+    }
+
+    if (rhsConst) {
+      if ((ins.op == OP_MUL || ins.op == OP_DIV) && rhs.imm == 1.0) {
+        out = right;
+        continue;
+      }
+      if ((ins.op == OP_SUB && isZero(rhs.imm, false)) ||
+          (ins.op == OP_ADD && isZero(rhs.imm, true))) {
+        out = right;
+        continue;
+      }
+      if (ins.op == OP_SUB && !std::isnan(rhs.imm)) {
+        rhs.imm = -rhs.imm;
+        ins.op = OP_ADD;
+      } else if (ins.op == OP_DIV && std::isnormal(rhs.imm)) {
+        int exponent;
+        double recip = 1.0 / rhs.imm;
+        if (std::fabs(std::frexp(rhs.imm, &exponent)) == 0.5 &&
+            std::isnormal(recip)) {
+          rhs.imm = recip;
+          ins.op = OP_MUL;
+        }
+      }
+    }
+
+    if (lhsConst && ((ins.op == OP_MUL && lhs.imm == 1.0) ||
+                     (ins.op == OP_ADD && isZero(lhs.imm, true)))) {
+      // drop the left constant and shift the right operand down
+      for (std::size_t j = right; j < out; j++) {
+        program[j - 1u] = program[j];
+      }
+      out--;
+      continue;
+    }
+
+    program[out++] = ins;
+  }
+
+  program.resize(out);
+}
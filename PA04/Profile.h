@@ -0,0 +1,533 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//-----------------------------------------------------------
+// instrumentation macros
+//-----------------------------------------------------------
+
+// Profiling is opt-in: build with -DRPN_PROFILE to record every stage
+// and operation. Otherwise the macros expand to nothing, so the
+// instrumented code is exactly the uninstrumented code.
+#ifdef RPN_PROFILE
+#define RPN_PROFILE_CONCAT2(a, b) a##b
+#define RPN_PROFILE_CONCAT(a, b) RPN_PROFILE_CONCAT2(a, b)
+
+/** Time the rest of the enclosing block as a stage. */
+#define RPN_PROFILE_STAGE(stage)                                             \
+  ProfileScope RPN_PROFILE_CONCAT(profileScope, __LINE__)(stage)
+
+/** Time the rest of the enclosing block as operation number op. */
+#define RPN_PROFILE_OP(op, name)                                             \
+  ProfileScope RPN_PROFILE_CONCAT(profileScope, __LINE__)(op, name)
+
+/** Print the summary and write the trace; see reportProfile(). */
+#define RPN_PROFILE_REPORT() reportProfile()
+#else
+#define RPN_PROFILE_STAGE(stage)
+#define RPN_PROFILE_OP(op, name)
+#define RPN_PROFILE_REPORT()
+#endif
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Stages of handling calculator input.
+ */
+enum ProfileStage {
+  /** Reading a token from the input. */
+  PROFILE_READ,
+  /** Parsing a token into an instruction. */
+  PROFILE_TOKENIZE,
+  /** Checking an expression's stack depth. */
+  PROFILE_CHECK,
+  /** Optimizing, fusing and running an expression. */
+  PROFILE_EVALUATE,
+  /** Formatting a value. */
+  PROFILE_FORMAT,
+  /** Writing output. */
+  PROFILE_WRITE,
+  /** Number of stages. */
+  PROFILE_STAGES
+};
+
+/**
+ * Get the current time in profiler ticks: TSC cycles on x86, which are
+ * cheap to read, and nanoseconds elsewhere.
+ *
+ * \return Ticks since an arbitrary start.
+ */
+inline std::uint64_t profileTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+/**
+ * Histogram of durations in ticks, with one bucket per power of two.
+ */
+struct ProfileHistogram {
+  /** Number of durations recorded. */
+  std::uint64_t count;
+
+  /** Sum of the durations. */
+  std::uint64_t total;
+
+  /** Longest duration. */
+  std::uint64_t max;
+
+  /** Bucket b counts durations below 2^b and at least 2^(b-1). */
+  std::uint64_t buckets[65];
+
+  /**
+   * Record a duration.
+   *
+   * \param ticks Duration to record.
+   */
+  void add(std::uint64_t ticks) {
+    count++;
+    total += ticks;
+    max = ticks > max ? ticks : max;
+    buckets[ticks == 0u ? 0 : 64 - __builtin_clzll(ticks)]++;
+  }
+
+  /**
+   * Get an upper bound on a percentile of the durations.
+   *
+   * \param p Percentile, from 0 to 100.
+   *
+   * \return Upper end of the bucket holding that percentile, or 0 if
+   * nothing has been recorded.
+   */
+  std::uint64_t percentile(double p) const {
+    std::uint64_t seen = 0u;
+    for (int b = 0; b < 65; b++) {
+      seen += buckets[b];
+      if (seen > 0u && seen >= p / 100.0 * count) {
+        return b == 0 ? 0u : b == 64 ? max : (std::uint64_t(1) << b) - 1u;
+      }
+    }
+    return 0u;
+  }
+};
+
+/**
+ * Class collecting the durations of calculator stages and operations:
+ * a histogram for each, and a timeline of individual events, up to a
+ * limit, for export as a trace. Not thread-safe; the calculator and its
+ * server run on one thread.
+ */
+class Profiler {
+public:
+  /** Largest operation number recorded, plus one. */
+  static const unsigned maxOps = 32u;
+
+  /**
+   * Constructor. Make an empty profile.
+   *
+   * \param maxEvents Most events to keep for the trace; histograms
+   * count every event regardless.
+   */
+  explicit Profiler(std::size_t maxEvents = std::size_t(1u) << 20);
+
+  /**
+   * Clear everything recorded.
+   */
+  void clear();
+
+  /**
+   * Get the number of events not kept for the trace.
+   *
+   * \return Events recorded after the limit was reached.
+   */
+  std::uint64_t droppedEvents() const { return dropped; }
+
+  /**
+   * Get the profiler the instrumentation macros record to.
+   *
+   * \return The process-wide profiler.
+   */
+  static Profiler &instance();
+
+  /**
+   * Get the histogram of an operation.
+   *
+   * \param op Operation number, below maxOps.
+   *
+   * \return Its histogram.
+   */
+  const ProfileHistogram &opHistogram(unsigned op) const { return ops[op]; }
+
+  /**
+   * Record one run of an operation.
+   *
+   * \param op Operation number; ones from maxOps up are ignored.
+   *
+   * \param name Name of the operation, for reports; must be a string
+   * constant.
+   *
+   * \param start Ticks at the start.
+   *
+   * \param end Ticks at the end.
+   */
+  void recordOp(unsigned op, const char *name, std::uint64_t start,
+                std::uint64_t end);
+
+  /**
+   * Record one pass through a stage.
+   *
+   * \param stage Stage.
+   *
+   * \param start Ticks at the start.
+   *
+   * \param end Ticks at the end.
+   */
+  void recordStage(ProfileStage stage, std::uint64_t start,
+                   std::uint64_t end);
+
+  /**
+   * Write a summary table: for each stage and operation seen, its
+   * count, total time, and mean, median, 99th percentile and maximum
+   * ticks.
+   *
+   * \param out Stream to write to.
+   */
+  void report(std::ostream &out) const;
+
+  /**
+   * Get the stage histogram.
+   *
+   * \param stage Stage.
+   *
+   * \return Its histogram.
+   */
+  const ProfileHistogram &stageHistogram(ProfileStage stage) const {
+    return stages[stage];
+  }
+
+  /**
+   * Estimate the tick rate from the ticks and wall-clock time elapsed
+   * since the profiler was made.
+   *
+   * \return Ticks per microsecond.
+   */
+  double ticksPerMicrosecond() const;
+
+  /**
+   * Write the kept events in the Chrome trace event format, for
+   * chrome://tracing or Perfetto: one complete ("X") event per stage
+   * or operation, with operations nested in their evaluate stage.
+   *
+   * \param out Stream to write the JSON to.
+   */
+  void writeTrace(std::ostream &out) const;
+
+private:
+  /** One timed event, for the trace. */
+  struct Event {
+    /** Name of the stage or operation. */
+    const char *name;
+
+    /** "stage" or "op". */
+    const char *category;
+
+    /** Ticks at the start. */
+    std::uint64_t start;
+
+    /** Ticks at the end. */
+    std::uint64_t end;
+  };
+
+  /** Histograms of the stages. */
+  ProfileHistogram stages[PROFILE_STAGES];
+
+  /** Histograms of the operations. */
+  ProfileHistogram ops[maxOps];
+
+  /** Names of the operations seen. */
+  const char *opNames[maxOps];
+
+  /** Events kept for the trace, in the order they ended. */
+  std::vector<Event> events;
+
+  /** Most events to keep. */
+  std::size_t maxEvents;
+
+  /** Number of events not kept. */
+  std::uint64_t dropped;
+
+  /** Ticks when the profiler was made. */
+  std::uint64_t startTicks;
+
+  /** Wall-clock time when the profiler was made. */
+  std::chrono::steady_clock::time_point startTime;
+
+  /**
+   * Keep an event for the trace, if there is room.
+   */
+  void keep(const char *name, const char *category, std::uint64_t start,
+            std::uint64_t end);
+};
+
+/**
+ * Class timing a stage or operation from its construction to the end of
+ * its scope, for the instrumentation macros.
+ */
+class ProfileScope {
+public:
+  /**
+   * Constructor. Start timing a stage.
+   *
+   * \param stage Stage being timed.
+   */
+  explicit ProfileScope(ProfileStage stage)
+      : profiler(Profiler::instance()), isOp(false), stage(stage), op(0u),
+        name(0), start(profileTicks()) {}
+
+  /**
+   * Constructor. Start timing an operation.
+   *
+   * \param op Operation number.
+   *
+   * \param name Name of the operation; must be a string constant.
+   */
+  ProfileScope(unsigned op, const char *name)
+      : profiler(Profiler::instance()), isOp(true), stage(PROFILE_STAGES),
+        op(op), name(name), start(profileTicks()) {}
+
+  /**
+   * Destructor. Record the time since construction.
+   */
+  ~ProfileScope() {
+    std::uint64_t end = profileTicks();
+    if (isOp) {
+      profiler.recordOp(op, name, start, end);
+    } else {
+      profiler.recordStage(stage, start, end);
+    }
+  }
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+  /** Profiler to record to, made before the clock is read. */
+  Profiler &profiler;
+
+  /** Set if an operation is being timed rather than a stage. */
+  bool isOp;
+
+  /** Stage being timed, if not isOp. */
+  ProfileStage stage;
+
+  /** Operation being timed, if isOp. */
+  unsigned op;
+
+  /** Name of the operation, or 0 for a stage. */
+  const char *name;
+
+  /** Ticks at construction. */
+  std::uint64_t start;
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/**
+ * Get a printable name for a stage.
+ *
+ * \param stage Stage.
+ *
+ * \return Name of the stage, e.g., "evaluate".
+ */
+inline const char *stageName(ProfileStage stage) {
+  static const char *names[PROFILE_STAGES] = {
+      "read", "tokenize", "check", "evaluate", "format", "write"};
+
+  return stage < PROFILE_STAGES ? names[stage] : "?";
+}
+
+/*
+ * Implementation of the Profiler constructor.
+ */
+inline Profiler::Profiler(std::size_t maxEvents)
+    : maxEvents(maxEvents), dropped(0u), startTicks(profileTicks()),
+      startTime(std::chrono::steady_clock::now()) {
+  clear();
+}
+
+/*
+ * Implementation of the clear method. The tick rate keeps being
+ * measured from construction.
+ */
+inline void Profiler::clear() {
+  for (unsigned i = 0u; i < PROFILE_STAGES; i++) {
+    stages[i] = ProfileHistogram();
+  }
+  for (unsigned i = 0u; i < maxOps; i++) {
+    ops[i] = ProfileHistogram();
+    opNames[i] = 0;
+  }
+  events.clear();
+  dropped = 0u;
+}
+
+/*
+ * Implementation of the instance method.
+ */
+inline Profiler &Profiler::instance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+/*
+ * Implementation of the recordOp method.
+ */
+inline void Profiler::recordOp(unsigned op, const char *name,
+                               std::uint64_t start, std::uint64_t end) {
+  if (op < maxOps) {
+    ops[op].add(end - start);
+    opNames[op] = name;
+    keep(name, "op", start, end);
+  }
+}
+
+/*
+ * Implementation of the recordStage method.
+ */
+inline void Profiler::recordStage(ProfileStage stage, std::uint64_t start,
+                                  std::uint64_t end) {
+  if (stage < PROFILE_STAGES) {
+    stages[stage].add(end - start);
+    keep(stageName(stage), "stage", start, end);
+  }
+}
+
+/*
+ * Implementation of the keep method. The vector grows on demand, so an
+ * unused profiler costs no memory for events.
+ */
+inline void Profiler::keep(const char *name, const char *category,
+                           std::uint64_t start, std::uint64_t end) {
+  if (events.size() < maxEvents) {
+    Event e = {name, category, start, end};
+    events.push_back(e);
+  } else {
+    dropped++;
+  }
+}
+
+/*
+ * Implementation of the report method.
+ */
+inline void Profiler::report(std::ostream &out) const {
+  double perUs = ticksPerMicrosecond();
+  char line[160];
+
+  std::snprintf(line, sizeof(line), "%.1f ticks/us; p50 and p99 are bucket"
+                " upper bounds", perUs);
+  out << line << std::endl;
+
+  for (int part = 0; part < 2; part++) {
+    unsigned n = part == 0 ? PROFILE_STAGES : maxOps;
+    std::snprintf(line, sizeof(line), "%-12s %10s %10s %8s %8s %8s %10s",
+                  part == 0 ? "stage" : "operation", "count", "total ms",
+                  "mean", "p50", "p99", "max");
+    out << line << std::endl;
+
+    for (unsigned i = 0u; i < n; i++) {
+      const ProfileHistogram &h = part == 0 ? stages[i] : ops[i];
+      if (h.count == 0u) {
+        continue;
+      }
+      std::snprintf(
+          line, sizeof(line),
+          "%-12s %10llu %10.2f %8.0f %8llu %8llu %10llu",
+          part == 0 ? stageName(static_cast<ProfileStage>(i)) : opNames[i],
+          static_cast<unsigned long long>(h.count), h.total / perUs / 1000.0,
+          static_cast<double>(h.total) / h.count,
+          static_cast<unsigned long long>(h.percentile(50.0)),
+          static_cast<unsigned long long>(h.percentile(99.0)),
+          static_cast<unsigned long long>(h.max));
+      out << line << std::endl;
+    }
+  }
+
+  if (dropped > 0u) {
+    out << dropped << " events not kept for the trace" << std::endl;
+  }
+}
+
+/*
+ * Implementation of the ticksPerMicrosecond method.
+ */
+inline double Profiler::ticksPerMicrosecond() const {
+  double us = std::chrono::duration<double, std::micro>(
+                  std::chrono::steady_clock::now() - startTime)
+                  .count();
+  std::uint64_t ticks = profileTicks() - startTicks;
+
+  return us > 0.0 && ticks > 0u ? ticks / us : 1.0;
+}
+
+/*
+ * Implementation of the writeTrace method. Times are microseconds from
+ * the profiler's construction, as the format expects.
+ */
+inline void Profiler::writeTrace(std::ostream &out) const {
+  double perUs = ticksPerMicrosecond();
+  char line[160];
+
+  out << "{\"traceEvents\":[";
+  for (std::size_t i = 0u; i < events.size(); i++) {
+    const Event &e = events[i];
+    std::snprintf(line, sizeof(line),
+                  "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                  "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+                  i == 0u ? "" : ",", e.name, e.category,
+                  static_cast<std::int64_t>(e.start - startTicks) / perUs,
+                  (e.end - e.start) / perUs);
+    out << line;
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}" << std::endl;
+}
+
+/**
+ * Print the process-wide profile to standard error and write its trace
+ * to the file named by the RPN_TRACE environment variable, or
+ * rpn-trace.json. Called through RPN_PROFILE_REPORT() at exit.
+ */
+inline void reportProfile() {
+  const char *traceName = std::getenv("RPN_TRACE");
+  if (!traceName) {
+    traceName = "rpn-trace.json";
+  }
+
+  Profiler::instance().report(std::cerr);
+  std::ofstream trace(traceName);
+  Profiler::instance().writeTrace(trace);
+  if (!trace) {
+    std::cerr << "Cannot write " << traceName << std::endl;
+  } else {
+    std::cerr << "Trace written to " << traceName << std::endl;
+  }
+}
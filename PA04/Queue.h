@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include "DLL.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a simple, templated queue, using a doubly-linked
+ * list as the underyling data structure.
+ *
+ * \tparam T Element type.
+ *
+ * \tparam Check Checking policy from CheckPolicy.h, passed on to the
+ * list; Checked throws std::out_of_range when the queue is empty.
+ */
+template <class T, class Check = Checked> class Queue {
+public:
+  /**
+   * Default constructor. Make a new, empty queue.
+   */
+  Queue() {}
+
+  /**
+   * Copy constructor. Make this queue just like an existing one.
+   *
+   * \param queue Queue to copy from.
+   */
+  Queue(const Queue<T, Check> &queue);
+
+  /**
+   * Remove all the elements from this queue.
+   */
+  void clear() { list.clear(); }
+
+  /**
+   * Remove the first element from the queue.
+   *
+   * \return First element from the queue.
+   */
+  T dequeue();
+
+  /**
+   * Add an element to the end of the queue.
+   *
+   * \param a Element to add to the queue.
+   */
+  void enqueue(const T &a) { list.addLast(a); }
+
+  /**
+   * Determine if this queue is empty.
+   *
+   * \return True if the queue is empty, false otherwise.
+   */
+  bool isEmpty() const { return list.isEmpty(); }
+
+  /**
+   * Have clear() and the destructor free the elements of a large queue
+   * on a background thread; see DLL::setReclaimer().
+   *
+   * \param pR Retirer to use, such as a Reclaimer, which must outlive
+   * the queue, or 0.
+   */
+  void setReclaimer(Retirer *pR) { list.setReclaimer(pR); }
+
+  /**
+   * Get the number of elements in the queue.
+   *
+   * \return Number of elements in the queue.
+   */
+  std::size_t size() const { return list.size(); }
+
+  /**
+   * Overloaded assignment operator.
+   *
+   * \param queuen Queue to copy from.
+   *
+   * \return A reference to this queue, for chaining.
+   */
+  Queue<T, Check> &operator=(const Queue<T, Check> &queue);
+
+  /**
+   * Override of the stream insertion operator for Queue objects.
+   *
+   * \param out ostream object to output to, e.g., cout
+   *
+   * \param queue Queue to output
+   *
+   * \return the out ostream object
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const Queue<T, Check> &queue) {
+
+    out << queue.list;
+    return out;
+  }
+
+private:
+  /**
+   * Doubly-linked list used as the underlying data structure for the
+   * queue.
+   */
+  DLL<T, Check> list;
+
+  /**
+   * Helper method to make this queue just like another one.
+   *
+   * \param queue Queue to copy from
+   */
+  void copy(const Queue<T, Check> &queue);
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the copy constructor.
+ */
+template <class T, class Check>
+Queue<T, Check>::Queue(const Queue<T, Check> &queue) { copy(queue); }
+
+/*
+ * Implementation of the copy helper method.
+ */
+template <class T, class Check>
+void Queue<T, Check>::copy(const Queue<T, Check> &queue) {
+  list = queue.list;
+}
+
+/*
+ * Implementation of the dequeue method.
+ */
+template <class T, class Check> T Queue<T, Check>::dequeue() {
+  Check::require(!list.isEmpty(), "Empty queue in Queue::dequeue()");
+  return list.removeFirst();
+}
+
+/*
+ * Overloaded assignment operator implementation.
+ */
+template <class T, class Check>
+Queue<T, Check> &Queue<T, Check>::operator=(const Queue<T, Check> &queue) {
+  copy(queue);
+  return *this;
+}
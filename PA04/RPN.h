@@ -0,0 +1,316 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include "FixedStack.h"
+#include "Stack.h"
+
+//-----------------------------------------------------------
+// token helpers
+//-----------------------------------------------------------
+
+/**
+ * Determine if the characters [first, last) form one of the four
+ * arithmetic operator tokens, +, -, * or /.
+ *
+ * \param first Pointer to the first character of the token.
+ *
+ * \param last Pointer one past the last character of the token.
+ *
+ * \return true if the token is an operator, false otherwise.
+ */
+constexpr bool isOperatorToken(const char *first, const char *last) {
+  return last - first == 1 &&
+         (*first == '+' || *first == '-' || *first == '*' || *first == '/');
+}
+
+/**
+ * Determine if the characters [first, last) form the "E" token that
+ * ends an expression.
+ *
+ * \param first Pointer to the first character of the token.
+ *
+ * \param last Pointer one past the last character of the token.
+ *
+ * \return true if the token is "E", false otherwise.
+ */
+constexpr bool isEndToken(const char *first, const char *last) {
+  return last - first == 1 && *first == 'E';
+}
+
+/**
+ * Apply one of the four arithmetic operators. This is the single
+ * definition of operator semantics shared by the compile-time and
+ * runtime calculators, so both produce bit-identical results.
+ *
+ * \param op Operator character, one of +, -, * or /.
+ *
+ * \param lhs Left operand, i.e., the element below the top of the stack.
+ *
+ * \param rhs Right operand, i.e., the element at the top of the stack.
+ *
+ * \return Result of lhs op rhs.
+ */
+constexpr double applyOperator(char op, double lhs, double rhs) {
+  switch (op) {
+  case '+':
+    return lhs + rhs;
+  case '-':
+    return lhs - rhs;
+  case '*':
+    return lhs * rhs;
+  case '/':
+    return lhs / rhs;
+  default:
+    throw std::invalid_argument("Unknown operator in applyOperator()");
+  }
+}
+
+/**
+ * Parse a decimal number token of the form [+-]digits[.digits][e[+-]digits]
+ * without any library support, so that it can run at compile time.
+ *
+ * The result is exact (correctly rounded, identical to strtod) when the
+ * significant digits fit in 2^53 and the decimal exponent is within
+ * +/-22, because it is then a single IEEE multiply or divide of two
+ * exactly representable values. Other well-formed numbers are rejected
+ * with inexact set to true, so callers can fall back to strtod.
+ *
+ * \param first Pointer to the first character of the token.
+ *
+ * \param last Pointer one past the last character of the token.
+ *
+ * \param value Set to the parsed value on success.
+ *
+ * \param inexact Set to true if the token is a well-formed number that
+ * cannot be converted exactly by this function.
+ *
+ * \return true if value was set, false otherwise.
+ */
+constexpr bool parseNumberExact(const char *first, const char *last,
+                                double &value, bool &inexact) {
+  const char *p = first;
+  bool negative = false;
+  unsigned long long mantissa = 0u;
+  int digits = 0, exponent = 0;
+  bool tooManyDigits = false;
+
+  inexact = false;
+
+  if (p != last && (*p == '+' || *p == '-')) {
+    negative = *p == '-';
+    ++p;
+  }
+
+  // integer and fractional digits, accumulated into one mantissa
+  bool seenDigit = false, seenPoint = false;
+  for (; p != last; ++p) {
+    if (*p == '.' && !seenPoint) {
+      seenPoint = true;
+    } else if (*p >= '0' && *p <= '9') {
+      seenDigit = true;
+      if (mantissa == 0u && *p == '0') {
+        // leading zeros add no significant digits
+      } else if (digits < 19) {
+        mantissa = mantissa * 10u + static_cast<unsigned>(*p - '0');
+        digits++;
+      } else {
+        tooManyDigits = true;
+        if (!seenPoint) {
+          exponent++;
+        }
+        continue;
+      }
+      if (seenPoint) {
+        exponent--;
+      }
+    } else {
+      break;
+    }
+  }
+
+  if (!seenDigit) {
+    return false;
+  }
+
+  // optional exponent
+  if (p != last && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negExp = false;
+    if (p != last && (*p == '+' || *p == '-')) {
+      negExp = *p == '-';
+      ++p;
+    }
+    if (p == last) {
+      return false;
+    }
+    int e = 0;
+    for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+      if (e < 10000) {
+        e = e * 10 + (*p - '0');
+      }
+    }
+    exponent += negExp ? -e : e;
+  }
+
+  if (p != last) {
+    return false;
+  }
+
+  const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                           1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                           1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  if (tooManyDigits || mantissa > (1ull << 53) || exponent > 22 ||
+      exponent < -22) {
+    inexact = mantissa != 0u;
+    if (!inexact) {
+      value = negative ? -0.0 : 0.0;
+    }
+    return !inexact;
+  }
+
+  double d = static_cast<double>(mantissa);
+  d = exponent < 0 ? d / powers[-exponent] : d * powers[exponent];
+  value = negative ? -d : d;
+
+  return true;
+}
+
+/**
+ * Parse a number token at runtime. Uses parseNumberExact, so results
+ * match the compile-time calculator, and falls back to strtod for
+ * well-formed numbers outside its exact range.
+ *
+ * \param token Token to parse.
+ *
+ * \param value Set to the parsed value on success.
+ *
+ * \return true if the token is a number, false otherwise.
+ */
+inline bool parseNumber(const std::string &token, double &value) {
+  const char *first = token.c_str();
+  const char *last = first + token.size();
+  bool inexact = false;
+
+  if (parseNumberExact(first, last, value, inexact)) {
+    return true;
+  }
+  if (!inexact) {
+    return false;
+  }
+
+  value = std::strtod(first, 0);
+  return true;
+}
+
+//-----------------------------------------------------------
+// compile-time calculator
+//-----------------------------------------------------------
+
+/**
+ * Evaluate a postfix expression at compile time, e.g.,
+ *
+ *   constexpr double x = evaluateRPN("3 4 + 5 * E");
+ *
+ * Tokens are separated by whitespace; evaluation stops at the "E"
+ * token or the end of the string. Semantics are those of the runtime
+ * calculator: numbers are pushed, operators pop the right then the
+ * left operand and push the result, and exactly one value must remain.
+ * Any error is reported by throwing, which makes a constant evaluation
+ * fail to compile.
+ *
+ * \tparam N Maximum stack depth.
+ *
+ * \param expr Postfix expression to evaluate.
+ *
+ * \return Value of the expression.
+ */
+template <std::size_t N = 64> constexpr double evaluateRPN(const char *expr) {
+  FixedStack<double, N> stack;
+  const char *p = expr;
+
+  while (*p != '\0') {
+    // skip whitespace, then find the end of the token
+    if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+      ++p;
+      continue;
+    }
+    const char *first = p;
+    while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r' &&
+           *p != '\n') {
+      ++p;
+    }
+
+    if (isEndToken(first, p)) {
+      break;
+    } else if (isOperatorToken(first, p)) {
+      double rhs = stack.pop();
+      double lhs = stack.pop();
+      stack.push(applyOperator(*first, lhs, rhs));
+    } else {
+      double value = 0.0;
+      bool inexact = false;
+      if (!parseNumberExact(first, p, value, inexact)) {
+        throw std::invalid_argument("Bad token in evaluateRPN()");
+      }
+      stack.push(value);
+    }
+  }
+
+  double result = stack.pop();
+  if (!stack.isEmpty()) {
+    throw std::invalid_argument("Leftover operands in evaluateRPN()");
+  }
+
+  return result;
+}
+
+//-----------------------------------------------------------
+// runtime calculator
+//-----------------------------------------------------------
+
+/**
+ * Apply one token to the runtime calculator stack.
+ *
+ * \param stack Operand stack.
+ *
+ * \param token Token to apply.
+ *
+ * \param result Set to the value of the expression when the token is
+ * "E".
+ *
+ * \return true if the token was "E" and result was set, false otherwise.
+ *
+ * \throws std::out_of_range if an operator or "E" finds too few operands.
+ *
+ * \throws std::invalid_argument for unknown tokens, or if operands are
+ * left over at "E".
+ */
+inline bool processToken(Stack<double> &stack, const std::string &token,
+                         double &result) {
+  const char *first = token.c_str();
+  const char *last = first + token.size();
+
+  if (isEndToken(first, last)) {
+    result = stack.pop();
+    if (!stack.isEmpty()) {
+      throw std::invalid_argument("Leftover operands in processToken()");
+    }
+    return true;
+  } else if (isOperatorToken(first, last)) {
+    double rhs = stack.pop();
+    double lhs = stack.pop();
+    stack.push(applyOperator(*first, lhs, rhs));
+  } else {
+    double value;
+    if (!parseNumber(token, value)) {
+      throw std::invalid_argument("Bad token in processToken()");
+    }
+    stack.push(value);
+  }
+
+  return false;
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Session.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * State of one client connection to the calculator server.
+ */
+struct Connection {
+  /**
+   * Constructor. Make the state for a newly accepted connection.
+   *
+   * \param fd Socket of the connection.
+   *
+   * \param engine Number type to evaluate expressions in.
+   */
+  Connection(int fd, Engine engine)
+      : fd(fd), session(engine), written(0u), skipping(false),
+        readDone(false) {}
+
+  /** Socket of the connection. */
+  int fd;
+
+  /** Calculator state, kept for the life of the connection. */
+  Session session;
+
+  /** Start of a token cut off by the end of the last read. */
+  std::string partial;
+
+  /** Output not yet written to the client. */
+  std::string out;
+
+  /** Number of bytes of out already written. */
+  std::size_t written;
+
+  /** Set while the rest of a token too long to keep is dropped. */
+  bool skipping;
+
+  /** Set once the client has closed its side. */
+  bool readDone;
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/**
+ * Set by SIGINT or SIGTERM to stop the server.
+ */
+inline volatile std::sig_atomic_t &serverStopping() {
+  static volatile std::sig_atomic_t stopping = 0;
+  return stopping;
+}
+
+/**
+ * Signal handler stopping the server.
+ */
+inline void stopServer(int) { serverStopping() = 1; }
+
+/**
+ * Feed the tokens in a block of bytes read from a connection to its
+ * session. A token cut off at the end is kept in partial until the
+ * next block, or the end of the input. No valid token is anywhere near
+ * 256 bytes, so a longer one is rejected as a bad token once it gets
+ * that long, and the rest of it and of its expression is dropped; a
+ * client sending no whitespace can't make partial grow without limit.
+ *
+ * \param c Connection the bytes came from.
+ *
+ * \param data Bytes read.
+ *
+ * \param size Number of bytes read; 0 at the end of the input.
+ */
+inline void feedBytes(Connection &c, const char *data, std::size_t size) {
+  const std::size_t maxToken = 256u;
+  std::string &token = c.partial;
+
+  for (std::size_t i = 0u; i < size; i++) {
+    char ch = data[i];
+    if (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '\f' ||
+        ch == '\v') {
+      if (!token.empty()) {
+        c.session.feed(token, c.out);
+        token.clear();
+      }
+      c.skipping = false;
+    } else if (!c.skipping) {
+      token += ch;
+      if (token.size() > maxToken) {
+        token.resize(16u);
+        c.session.reject(token + "...", c.out);
+        token.clear();
+        c.skipping = true;
+      }
+    }
+  }
+
+  if (size == 0u) {
+    if (!token.empty()) {
+      c.session.feed(token, c.out);
+      token.clear();
+    }
+    c.skipping = false;
+  }
+}
+
+/**
+ * Write as much pending output to a connection as it will take.
+ *
+ * \param c Connection to write to.
+ *
+ * \return false if the connection failed.
+ */
+inline bool flushOutput(Connection &c) {
+  while (c.written < c.out.size()) {
+    ssize_t k = send(c.fd, c.out.data() + c.written, c.out.size() - c.written,
+                     MSG_NOSIGNAL);
+    if (k < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    c.written += static_cast<std::size_t>(k);
+  }
+
+  c.out.clear();
+  c.written = 0u;
+  return true;
+}
+
+/**
+ * Run the calculator as a server on a Unix domain socket until SIGINT
+ * or SIGTERM. Clients send "E"-terminated postfix expressions, as many
+ * as they like without waiting, and get one line back per expression,
+ * in order, as soon as it has been evaluated; like any token, the "E"
+ * must be followed by whitespace or the end of the input. Each
+ * connection has its own Session, reused for every expression on it.
+ *
+ * One thread serves every connection with poll(); a connection's input
+ * isn't read while more than a megabyte of its output is waiting, so a
+ * client that doesn't read its replies can't make the server buffer
+ * without limit.
+ *
+ * \param path File name of the socket; an existing socket there, e.g.,
+ * left by a server that was killed, is replaced, but any other file is
+ * left alone and the server fails. The socket is removed on exit.
+ *
+ * \param engine Number type every session evaluates expressions in.
+ *
+ * \return EXIT_SUCCESS after a signal, EXIT_FAILURE if the socket can't
+ * be set up.
+ */
+inline int serve(const std::string &path, Engine engine = ENGINE_DOUBLE) {
+  const std::size_t maxPending = std::size_t(1u) << 20;
+
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::cerr << "Socket path too long: " << path << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::strcpy(addr.sun_path, path.c_str());
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct stat existing;
+  if (lstat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+    unlink(path.c_str());
+  }
+  if (listener < 0 ||
+      bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+      listen(listener, 64) < 0) {
+    std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno)
+              << std::endl;
+    if (listener >= 0) {
+      close(listener);
+    }
+    return EXIT_FAILURE;
+  }
+  fcntl(listener, F_SETFL, fcntl(listener, F_GETFL) | O_NONBLOCK);
+
+  // no SA_RESTART, so that poll() returns when a signal arrives
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = stopServer;
+  sigaction(SIGINT, &action, 0);
+  sigaction(SIGTERM, &action, 0);
+
+  std::vector<Connection *> connections;
+  std::vector<pollfd> fds;
+  std::vector<char> buffer(65536u);
+
+  while (!serverStopping()) {
+    fds.clear();
+    pollfd lp = {listener, POLLIN, 0};
+    fds.push_back(lp);
+    for (std::size_t i = 0u; i < connections.size(); i++) {
+      Connection &c = *connections[i];
+      short events = 0;
+      if (!c.readDone && c.out.size() < maxPending) {
+        events |= POLLIN;
+      }
+      if (!c.out.empty()) {
+        events |= POLLOUT;
+      }
+      pollfd p = {c.fd, events, 0};
+      fds.push_back(p);
+    }
+
+    // the timeout covers a signal arriving just before poll()
+    if (poll(fds.data(), fds.size(), 250) <= 0) {
+      continue;
+    }
+
+    // serve the existing connections, dropping finished ones
+    std::size_t kept = 0u;
+    for (std::size_t i = 0u; i < connections.size(); i++) {
+      Connection *pC = connections[i];
+      const pollfd &p = fds[i + 1u];
+      bool ok = true;
+
+      if ((p.events & POLLIN) && (p.revents & (POLLIN | POLLHUP | POLLERR))) {
+        ssize_t k;
+        {
+          RPN_PROFILE_STAGE(PROFILE_READ);
+          k = read(pC->fd, buffer.data(), buffer.size());
+        }
+        if (k > 0) {
+          feedBytes(*pC, buffer.data(), static_cast<std::size_t>(k));
+        } else if (k == 0) {
+          feedBytes(*pC, buffer.data(), 0u);
+          pC->readDone = true;
+        } else if (errno != EAGAIN && errno != EINTR) {
+          ok = false;
+        }
+      }
+      if (ok && !pC->out.empty()) {
+        RPN_PROFILE_STAGE(PROFILE_WRITE);
+        ok = flushOutput(*pC);
+      }
+
+      if (!ok || (pC->readDone && pC->out.empty())) {
+        close(pC->fd);
+        delete pC;
+      } else {
+        connections[kept++] = pC;
+      }
+    }
+    connections.resize(kept);
+
+    // accept new connections
+    if (fds[0].revents & POLLIN) {
+      int fd;
+      while ((fd = accept(listener, 0, 0)) >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        connections.push_back(new Connection(fd, engine));
+      }
+    }
+  }
+
+  for (std::size_t i = 0u; i < connections.size(); i++) {
+    close(connections[i]->fd);
+    delete connections[i];
+  }
+  close(listener);
+  unlink(path.c_str());
+  RPN_PROFILE_REPORT();
+
+  return EXIT_SUCCESS;
+}
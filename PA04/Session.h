@@ -0,0 +1,354 @@
+#pragma once
+
+#include <cstdio>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include "Bytecode.h"
+#include "Fixed.h"
+#include "Infix.h"
+#include "Optimizer.h"
+#include "Profile.h"
+#include "Stack.h"
+
+//-----------------------------------------------------------
+// numeric engines
+//-----------------------------------------------------------
+
+/**
+ * Number types a session can evaluate expressions in.
+ */
+enum Engine {
+  /** IEEE double, the calculator's original arithmetic. */
+  ENGINE_DOUBLE,
+  /** IEEE single precision. */
+  ENGINE_FLOAT,
+  /** long double, e.g., x87 80-bit extended precision. */
+  ENGINE_LONG_DOUBLE,
+  /** Fixed, deterministic saturating fixed point. */
+  ENGINE_FIXED
+};
+
+/**
+ * Get an engine by name, as given on the command line.
+ *
+ * \param name "double", "float", "long-double" or "fixed".
+ *
+ * \param engine Set to the engine, if the name is known.
+ *
+ * \return true if the name is known.
+ */
+inline bool parseEngine(const std::string &name, Engine &engine) {
+  static const char *names[] = {"double", "float", "long-double", "fixed"};
+
+  for (int i = 0; i < 4; i++) {
+    if (name == names[i]) {
+      engine = static_cast<Engine>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Format a value as the calculator prints it: %g, which is what an
+ * ostream prints by default, after converting to double if needed.
+ *
+ * \param text Buffer to format into.
+ *
+ * \param size Size of the buffer.
+ *
+ * \param value Value to format.
+ */
+inline void formatValue(char *text, std::size_t size, double value) {
+  std::snprintf(text, size, "%g", value);
+}
+
+/* Overload of formatValue for long double, which %Lg prints directly. */
+inline void formatValue(char *text, std::size_t size, long double value) {
+  std::snprintf(text, size, "%Lg", value);
+}
+
+/* Overload of formatValue for Fixed. */
+inline void formatValue(char *text, std::size_t size, Fixed value) {
+  formatValue(text, size, static_cast<double>(value));
+}
+
+/**
+ * Read the next whitespace-separated token from a stream.
+ *
+ * \param in Stream to read from.
+ *
+ * \param token Set to the token read.
+ *
+ * \return false at the end of the input.
+ */
+inline bool readToken(std::istream &in, std::string &token) {
+  RPN_PROFILE_STAGE(PROFILE_READ);
+  return static_cast<bool>(in >> token);
+}
+
+/**
+ * Read the next line from a stream.
+ *
+ * \param in Stream to read from.
+ *
+ * \param line Set to the line read, without its newline.
+ *
+ * \return false at the end of the input.
+ */
+inline bool readLine(std::istream &in, std::string &line) {
+  RPN_PROFILE_STAGE(PROFILE_READ);
+  return static_cast<bool>(std::getline(in, line));
+}
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing one calculator session: the state for a stream of
+ * "E"-terminated postfix expressions, fed one token at a time. The
+ * operand stack and program buffer are kept between expressions, so a
+ * long-running session doesn't reallocate them.
+ *
+ * Expressions are evaluated in the session's engine. Constant folding
+ * is done in double, so it is only applied for the double engine; the
+ * others evaluate every operation in their own type.
+ *
+ * Each expression produces exactly one line of output, ">>> " followed
+ * by its value or an error, so a client can match replies to requests
+ * by counting lines.
+ */
+class Session {
+public:
+  /**
+   * Constructor. Make a session with nothing read yet.
+   *
+   * \param engine Number type to evaluate expressions in.
+   */
+  explicit Session(Engine engine = ENGINE_DOUBLE)
+      : engine(engine), discarding(false) {}
+
+  /**
+   * Feed the next token, appending any output it produces.
+   *
+   * \param token Number, parameter, operator or "E".
+   *
+   * \param out String to append output lines to.
+   */
+  void feed(const std::string &token, std::string &out);
+
+  /**
+   * Evaluate a whole infix expression, e.g., "(3 + 4) * 2", appending
+   * its output line; see compileInfix(). A blank line produces no
+   * output. Not to be called in the middle of a postfix expression.
+   *
+   * \param line Infix expression, without "E".
+   *
+   * \param out String to append output lines to.
+   */
+  void feedInfix(const std::string &line, std::string &out);
+
+  /**
+   * Reject a token without compiling it, e.g., one too long to be read
+   * whole: the error is output as for a bad token, and the rest of the
+   * expression is skipped.
+   *
+   * \param token Token, or as much of it as should be shown.
+   *
+   * \param out String to append output lines to.
+   */
+  void reject(const std::string &token, std::string &out);
+
+private:
+  /** Number type expressions are evaluated in. */
+  Engine engine;
+
+  /**
+   * Operand stack for the double engine, reused between expressions.
+   * The stacks are Unchecked: finish() runs only programs checkDepth()
+   * accepts, which can't pop an empty stack.
+   */
+  Stack<double, Unchecked> stack;
+
+  /** Operand stack for the float engine. */
+  Stack<float, Unchecked> floatStack;
+
+  /** Operand stack for the long double engine. */
+  Stack<long double, Unchecked> longStack;
+
+  /** Operand stack for the fixed-point engine. */
+  Stack<Fixed, Unchecked> fixedStack;
+
+  /** Program for the expression being read. */
+  Program program;
+
+  /** Program converted for the float engine. */
+  BasicProgram<float> floatProgram;
+
+  /** Program converted for the long double engine. */
+  BasicProgram<long double> longProgram;
+
+  /** Program converted for the fixed-point engine. */
+  BasicProgram<Fixed> fixedProgram;
+
+  /** Set after an error, so the rest of the bad expression is skipped. */
+  bool discarding;
+
+  /**
+   * Evaluate the fused program in another number type.
+   *
+   * \param converted Buffer for the converted program.
+   *
+   * \param typedStack Operand stack of that type.
+   *
+   * \param text Buffer to format the value into.
+   *
+   * \param size Size of the buffer.
+   */
+  template <class Num>
+  void evaluate(BasicProgram<Num> &converted,
+                Stack<Num, Unchecked> &typedStack, char *text,
+                std::size_t size);
+
+  /**
+   * Evaluate the program read so far and append its output line.
+   *
+   * \param out String to append the output line to.
+   */
+  void finish(std::string &out);
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Implementation of the feed method.
+ */
+inline void Session::feed(const std::string &token, std::string &out) {
+  if (token == "E") {
+    if (!discarding) {
+      finish(out);
+    }
+    program.clear();
+    discarding = false;
+  } else if (!discarding) {
+    RPN_PROFILE_STAGE(PROFILE_TOKENIZE);
+    if (!compileToken(token, program)) {
+      reject(token, out);
+    }
+  }
+}
+
+/*
+ * Implementation of the feedInfix method.
+ */
+inline void Session::feedInfix(const std::string &line, std::string &out) {
+  if (line.find_first_not_of(" \t\r\n\f\v") == std::string::npos) {
+    return;
+  }
+
+  std::string error;
+  bool ok;
+  {
+    RPN_PROFILE_STAGE(PROFILE_TOKENIZE);
+    ok = compileInfix(line, program, error);
+  }
+  if (ok) {
+    finish(out);
+  } else {
+    out += ">>> Error: ";
+    out += error;
+    out += '\n';
+  }
+  program.clear();
+  discarding = false;
+}
+
+/*
+ * Implementation of the reject method.
+ */
+inline void Session::reject(const std::string &token, std::string &out) {
+  if (!discarding) {
+    out += ">>> Error: Bad token ";
+    out += token;
+    out += '\n';
+    discarding = true;
+  }
+}
+
+/*
+ * Implementation of the finish method.
+ */
+inline void Session::finish(std::string &out) {
+  // check the stack depth first, so that malformed expressions are
+  // rejected without an exception; then fold constants (in double
+  // only), fuse superinstructions and run
+  RunStatus status;
+  {
+    RPN_PROFILE_STAGE(PROFILE_CHECK);
+    status = checkDepth(program);
+  }
+  if (status != RUN_OK) {
+    out += ">>> Error: ";
+    out += runStatusMessage(status);
+    out += '\n';
+  } else {
+    try {
+      char text[32];
+      switch (engine) {
+      case ENGINE_FLOAT:
+        evaluate(floatProgram, floatStack, text, sizeof(text));
+        break;
+      case ENGINE_LONG_DOUBLE:
+        evaluate(longProgram, longStack, text, sizeof(text));
+        break;
+      case ENGINE_FIXED:
+        evaluate(fixedProgram, fixedStack, text, sizeof(text));
+        break;
+      default: {
+        double value;
+        {
+          RPN_PROFILE_STAGE(PROFILE_EVALUATE);
+          optimize(program);
+          fuse(program);
+          value = run(program, stack);
+        }
+        RPN_PROFILE_STAGE(PROFILE_FORMAT);
+        formatValue(text, sizeof(text), value);
+      }
+      }
+      out += ">>> ";
+      out += text;
+      out += '\n';
+    } catch (const std::exception &e) {
+      out += ">>> Error: ";
+      out += e.what();
+      out += '\n';
+      stack.clear();
+      floatStack.clear();
+      longStack.clear();
+      fixedStack.clear();
+    }
+  }
+}
+
+/*
+ * Implementation of the evaluate method.
+ */
+template <class Num>
+void Session::evaluate(BasicProgram<Num> &converted,
+                       Stack<Num, Unchecked> &typedStack, char *text,
+                       std::size_t size) {
+  Num value;
+  {
+    RPN_PROFILE_STAGE(PROFILE_EVALUATE);
+    fuse(program);
+    convertProgram(program, converted);
+    value = run(converted, typedStack);
+  }
+  RPN_PROFILE_STAGE(PROFILE_FORMAT);
+  formatValue(text, size, value);
+}
@@ -1,152 +1,209 @@
-#pragma once
-
-#include <iostream>
-#include <stdexcept>
-#include "DLL.h"
-
-//-----------------------------------------------------------
-// class definitions
-//-----------------------------------------------------------
-
-/**
- * Class representing a simple, templated stack, using a doubly-linked
- * list as the underyling data structure.
- */
-template <class T> class Stack {
-public:
-  /**
-   * Default constructor. Make a new, empty stack.
-   */
-  Stack() {}
-
-  /**
-   * Copy constructor. Make this Stack just like an existing one.
-   *
-   * \param stack Stack to copy from.
-   */
-  Stack(const Stack<T> &stack);
-
-  /**
-   * Remove all elements from this stack.
-   */
-  void clear() { list.clear(); }
-
-  /**
-   * Determine if the stack is empty.
-   *
-   * \return True if the stack is empty, false if it has elements.
-   */
-  bool isEmpty() { return list.isEmpty(); }
-
-  /**
-   * Get a reference to the top element on the stack, without removing
-   * it.
-   *
-   * \return Reference to the element at he top of the stack.
-   */
-  T &peek() const;
-
-  /**
-   * Pop the top element from the stack.
-   *
-   * \return Element of type T that was at the top of the stack.
-   */
-  T pop();
-
-  /**
-   * Push a new item onto the stack.
-   *
-   * \param a Element of type T to push onto the stack.
-   */
-  void push(const T &a) { list.addFirst(a); }
-
-  /**
-   * Get the number of elements in the stack.
-   *
-   * \return Number of elements in the stack.
-   */
-  unsigned size() { return list.size(); }
-
-  /**
-   * Overloaded assignment operator.
-   *
-   * \param stack Stack to copy.
-   *
-   * \return Reference to this stack, for chaining.
-   */
-  Stack<T> &operator=(const Stack<T> &stack);
-
-  /**
-   * Override of the stream insertion operator for Stack objects.
-   *
-   * \param out ostream object to output to, e.g., cout
-   *
-   * \param stack Stack to output
-   *
-   * \return the out ostream object
-   */
-  friend std::ostream &operator<<(std::ostream &out, const Stack<T> &stack) {
-
-    out << stack.list;
-    return out;
-  }
-
-private:
-  /**
-   * Doubly-linked list used as the underlying data structure for the
-   * stack.
-   */
-  DLL<T> list;
-
-  /**
-   * Private helper for copy constructor and assignment operator.
-   *
-   * \param stack
-   */
-  void copy(const Stack<T> &stack);
-};
-
-//-----------------------------------------------------------
-// function implementations
-//-----------------------------------------------------------
-
-/*
- * Copy constructor implementation.
- */
-template <class T> Stack<T>::Stack(const Stack<T> &stack) { copy(stack); }
-
-/*
- * Copy helper fucntion implementation.
- */
-template <class T> void Stack<T>::copy(const Stack<T> &stack) {
-  clear();
-  list = stack.list;
-}
-
-/*
- * Peek function implementation.
- */
-template <class T> T &Stack<T>::peek() const {
-  if (list.isEmpty()) {
-    throw std::out_of_range("Empty stack in Stack::peek()");
-  }
-  return list.getFirst();
-}
-
-/*
- * Pop function implementation.
- */
-template <class T> T Stack<T>::pop() {
-  if (list.isEmpty()) {
-    throw std::out_of_range("Empty stack in Stack::pop()");
-  }
-  return list.removeFirst();
-}
-
-/*
- * Overloaded assignment operator implementation.
- */
-template <class T> Stack<T> &Stack<T>::operator=(const Stack<T> &stack) {
-  copy(stack);
-  return *this;
-}
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include "DLL.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Class representing a simple, templated stack, using a doubly-linked
+ * list as the underyling data structure.
+ *
+ * \tparam T Element type.
+ *
+ * \tparam Check Checking policy from CheckPolicy.h, passed on to the
+ * list; Checked throws std::out_of_range when the stack is empty.
+ */
+template <class T, class Check = Checked> class Stack {
+public:
+  /**
+   * Default constructor. Make a new, empty stack.
+   */
+  Stack() {}
+
+  /**
+   * Copy constructor. Make this Stack just like an existing one.
+   *
+   * \param stack Stack to copy from.
+   */
+  Stack(const Stack<T, Check> &stack);
+
+  /**
+   * Remove all elements from this stack.
+   */
+  void clear() { list.clear(); }
+
+  /**
+   * Determine if the stack is empty.
+   *
+   * \return True if the stack is empty, false if it has elements.
+   */
+  bool isEmpty() { return list.isEmpty(); }
+
+  /**
+   * Get a reference to the top element on the stack, without removing
+   * it.
+   *
+   * \return Reference to the element at he top of the stack.
+   */
+  T &peek() const;
+
+  /**
+   * Pop the top element from the stack.
+   *
+   * \return Element of type T that was at the top of the stack.
+   */
+  T pop();
+
+  /**
+   * Push a new item onto the stack.
+   *
+   * \param a Element of type T to push onto the stack.
+   */
+  void push(const T &a) { list.addFirst(a); }
+
+  /**
+   * Have clear() and the destructor free the elements of a large stack
+   * on a background thread; see DLL::setReclaimer().
+   *
+   * \param pR Retirer to use, such as a Reclaimer, which must outlive
+   * the stack, or 0.
+   */
+  void setReclaimer(Retirer *pR) { list.setReclaimer(pR); }
+
+  /**
+   * Get the number of elements in the stack.
+   *
+   * \return Number of elements in the stack.
+   */
+  std::size_t size() { return list.size(); }
+
+  /**
+   * Copy the top element without removing it, if there is one; never
+   * throws for an empty stack, whatever the checking policy.
+   *
+   * \param a Set to the top element, or left unchanged.
+   *
+   * \return true if the stack had an element, false if it was empty.
+   */
+  bool tryPeek(T &a) const;
+
+  /**
+   * Pop the top element, if there is one; never throws for an empty
+   * stack, whatever the checking policy.
+   *
+   * \param a Set to the element removed, or left unchanged.
+   *
+   * \return true if an element was removed, false if the stack was
+   * empty.
+   */
+  bool tryPop(T &a);
+
+  /**
+   * Overloaded assignment operator.
+   *
+   * \param stack Stack to copy.
+   *
+   * \return Reference to this stack, for chaining.
+   */
+  Stack<T, Check> &operator=(const Stack<T, Check> &stack);
+
+  /**
+   * Override of the stream insertion operator for Stack objects.
+   *
+   * \param out ostream object to output to, e.g., cout
+   *
+   * \param stack Stack to output
+   *
+   * \return the out ostream object
+   */
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const Stack<T, Check> &stack) {
+
+    out << stack.list;
+    return out;
+  }
+
+private:
+  /**
+   * Doubly-linked list used as the underlying data structure for the
+   * stack.
+   */
+  DLL<T, Check> list;
+
+  /**
+   * Private helper for copy constructor and assignment operator.
+   *
+   * \param stack
+   */
+  void copy(const Stack<T, Check> &stack);
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/*
+ * Copy constructor implementation.
+ */
+template <class T, class Check>
+Stack<T, Check>::Stack(const Stack<T, Check> &stack) { copy(stack); }
+
+/*
+ * Copy helper fucntion implementation.
+ */
+template <class T, class Check>
+void Stack<T, Check>::copy(const Stack<T, Check> &stack) {
+  list = stack.list;
+}
+
+/*
+ * Peek function implementation.
+ */
+template <class T, class Check> T &Stack<T, Check>::peek() const {
+  Check::require(!list.isEmpty(), "Empty stack in Stack::peek()");
+  return list.getFirst();
+}
+
+/*
+ * Pop function implementation.
+ */
+template <class T, class Check> T Stack<T, Check>::pop() {
+  Check::require(!list.isEmpty(), "Empty stack in Stack::pop()");
+  return list.removeFirst();
+}
+
+/*
+ * Implementation of the tryPeek method.
+ */
+template <class T, class Check> bool Stack<T, Check>::tryPeek(T &a) const {
+  if (list.isEmpty()) {
+    return false;
+  }
+  a = list.getFirst();
+  return true;
+}
+
+/*
+ * Implementation of the tryPop method.
+ */
+template <class T, class Check> bool Stack<T, Check>::tryPop(T &a) {
+  if (list.isEmpty()) {
+    return false;
+  }
+  a = list.removeFirst();
+  return true;
+}
+
+/*
+ * Overloaded assignment operator implementation.
+ */
+template <class T, class Check>
+Stack<T, Check> &Stack<T, Check>::operator=(const Stack<T, Check> &stack) {
+  copy(stack);
+  return *this;
+}
@@ -0,0 +1,99 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Batch.h"
+#include "Bytecode.h"
+#include "Session.h"
+#include "TestCheck.h"
+#include "Workload.h"
+
+using namespace std;
+
+/**
+ * Compile postfix text into a program.
+ */
+static Program compile(const string &postfix) {
+  istringstream in(postfix);
+  string token;
+  Program program;
+  while (in >> token) {
+    compileToken(token, program);
+  }
+  return program;
+}
+
+/**
+ * Feed every token of postfix text to a session and to a batch session,
+ * returning whether their output is the same.
+ */
+static bool sameOutput(const string &postfix, BatchSession &batch) {
+  Session session;
+  istringstream in(postfix);
+  string token, out, batchOut;
+  while (in >> token) {
+    session.feed(token, out);
+    batch.feed(token);
+  }
+  batch.flush(batchOut);
+  return out == batchOut;
+}
+
+int main() {
+  // a subexpression shared by expressions, or within one, is one node
+  ExpressionBatch batch;
+  size_t a = batch.add(compile("3 4 + 2 *"));
+  size_t b = batch.add(compile("3 4 + 3 4 + /"));
+  size_t c = batch.add(compile("3 4 + 2 *"));
+  check(a == c, "equal expressions, equal nodes");
+  check(batch.distinct() == 6u, "3, 4, +, 2, *, /");
+  batch.evaluate();
+  check(batch.value(a) == 14.0 && batch.value(b) == 1.0, "values");
+  check(batch.operationCount() == 17u && batch.evaluatedCount() == 6u,
+        "statistics");
+
+  // constants match by bits: 0 and -0 differ, and equal NaNs match
+  batch.clear();
+  a = batch.add(compile("1 0 /"));
+  b = batch.add(compile("1 -0 /"));
+  c = batch.add(compile("0 0 / 1 +"));
+  size_t d = batch.add(compile("0 0 / 1 +"));
+  batch.evaluate();
+  check(batch.value(a) > 0.0 && batch.value(b) < 0.0, "signed zero");
+  check(c == d && batch.value(c) != batch.value(c), "NaN");
+  check(batch.evaluatedCount() == 6u + 7u, "statistics over clears");
+
+  // order matters: 8 2 - is not 2 8 -
+  batch.clear();
+  a = batch.add(compile("8 2 -"));
+  b = batch.add(compile("2 8 -"));
+  batch.evaluate();
+  check(a != b && batch.value(a) == 6.0 && batch.value(b) == -6.0,
+        "operand order");
+
+  // a batch session replies as a session does, errors included, and
+  // keeps an unfinished expression for the next flush
+  BatchSession session;
+  check(sameOutput("3 4 + E 3 4 + 2 * E 1 + E 2 y 3 E 1 2 E 5 E", session),
+        "replies and errors");
+  check(session.statistics().evaluatedCount() == 3u + 2u + 1u,
+        "batch session statistics");
+  string out;
+  session.feed("5");
+  session.flush(out);
+  check(out.empty(), "unfinished expression waits");
+  session.feed("E");
+  session.flush(out);
+  check(out == ">>> 5\n", "unfinished expression finished");
+
+  // and over a generated workload with malformed expressions
+  WorkloadOptions options;
+  options.expressions = 5000;
+  options.malformedPercent = 10u;
+  ostringstream workload;
+  generateWorkload(options, workload, 0);
+  BatchSession generated;
+  check(sameOutput(workload.str(), generated), "generated workload");
+
+  return finishChecks();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//-----------------------------------------------------------
+// helper functions
+//-----------------------------------------------------------
+
+/** Number of failed checks. */
+static unsigned failures = 0u;
+
+/**
+ * Report a failed check.
+ *
+ * \param ok Result of the check.
+ *
+ * \param what Description of what was checked.
+ */
+static void check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::cout << "FAILED: " << what << std::endl;
+    failures++;
+  }
+}
+
+/**
+ * Print the number of failed checks, at the end of a test.
+ *
+ * \return Exit status for main(): EXIT_SUCCESS if no check failed.
+ */
+static int finishChecks() {
+  std::cout << failures << " failures" << std::endl;
+  return failures == 0u ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,138 @@
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Checkpoint.h"
+#include "TestCheck.h"
+#include "Workload.h"
+
+using namespace std;
+
+/**
+ * Start the calculator on files, with more options if given, returning
+ * its process id.
+ */
+static pid_t start(const string &in, const string &out,
+                   const char *option1 = 0, const char *option2 = 0,
+                   const char *option3 = 0, const char *option4 = 0,
+                   const char *option5 = 0) {
+  pid_t child = fork();
+  if (child == 0) {
+    execl("./assgn04", "./assgn04", "--input", in.c_str(), "--output",
+          out.c_str(), option1, option2, option3, option4, option5,
+          static_cast<char *>(0));
+    _exit(127);
+  }
+  return child;
+}
+
+/**
+ * Wait for the calculator to exit, returning true if it succeeded.
+ */
+static bool succeeded(pid_t child) {
+  int status = 0;
+  return child > 0 && waitpid(child, &status, 0) == child &&
+         WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+/**
+ * Read a whole file.
+ */
+static string readFile(const string &path) {
+  ifstream in(path.c_str(), ios::binary);
+  ostringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+/**
+ * Write a whole file.
+ */
+static void writeFile(const string &path, const string &text) {
+  ofstream out(path.c_str(), ios::binary | ios::trunc);
+  out << text;
+}
+
+int main() {
+  string base = "/tmp/TestCheckpoint." + to_string(getpid());
+  string in = base + ".in", out = base + ".out", ref = base + ".ref";
+  string ck = base + ".ck";
+
+  // checkpoints round trip, and malformed ones are refused
+  Checkpoint saved, loaded;
+  saved.inputOffset = 123456789012ull;
+  saved.expressions = 42u;
+  saved.outputOffset = 987u;
+  check(writeCheckpoint(ck, saved) && readCheckpoint(ck, loaded) &&
+            loaded.inputOffset == saved.inputOffset &&
+            loaded.expressions == 42u && loaded.outputOffset == 987u,
+        "round trip");
+  writeFile(ck, "rpn-checkpoint 1 2\n");
+  check(!readCheckpoint(ck, loaded) && loaded.expressions == 42u,
+        "truncated checkpoint");
+  check(!readCheckpoint(base + ".missing", loaded), "missing checkpoint");
+  check(!succeeded(start(in, out, "--checkpoint", (base + ".missing").c_str(),
+                         "--resume")),
+        "resume without a checkpoint");
+
+  // a large run, killed part way through, then resumed
+  WorkloadOptions options;
+  options.expressions = 200000;
+  options.malformedPercent = 5u;
+  ofstream workload(in.c_str());
+  generateWorkload(options, workload, 0);
+  workload.close();
+  check(succeeded(start(in, ref)), "reference run");
+
+  remove(ck.c_str());
+  pid_t child = start(in, out, "--checkpoint", ck.c_str(),
+                      "--checkpoint-every", "500");
+  Checkpoint progress;
+  for (int i = 0; i < 20000 && progress.expressions < 10000u; i++) {
+    usleep(500);
+    readCheckpoint(ck, progress);
+  }
+  kill(child, SIGKILL);
+  waitpid(child, 0, 0);
+  check(readCheckpoint(ck, progress) && progress.expressions >= 10000u &&
+            progress.expressions < 200000u,
+        "killed part way");
+  cout << "killed after checkpoint of " << progress.expressions
+       << " expressions" << endl;
+
+  // the input before the checkpoint is blanked, so resuming gives the
+  // same output only if it doesn't read it again
+  string text = readFile(in);
+  writeFile(in, string(progress.inputOffset, ' ') +
+                    text.substr(progress.inputOffset));
+  check(succeeded(start(in, out, "--checkpoint", ck.c_str(), "--resume")),
+        "resumed run");
+  check(readFile(out) == readFile(ref), "resumed output is identical");
+
+  // in infix, replies written after the checkpoint are cut off and
+  // written again
+  writeFile(in, "1 + 2\n(3\n\n4 * 5\n6 / 0\n7 -\n8 - 9\n");
+  check(succeeded(start(in, ref, "--infix")), "infix reference run");
+  check(succeeded(start(in, out, "--infix", "--checkpoint", ck.c_str(),
+                        "--checkpoint-every", "3")),
+        "infix checkpointed run");
+  check(readFile(out) == readFile(ref), "infix checkpointed output");
+  check(readCheckpoint(ck, progress) && progress.expressions == 6u,
+        "infix checkpoint");
+  writeFile(out, readFile(out).substr(0u, progress.outputOffset) +
+                     ">>> replies after the checkpoint\n");
+  check(succeeded(start(in, out, "--infix", "--checkpoint", ck.c_str(),
+                        "--resume")),
+        "infix resumed run");
+  check(readFile(out) == readFile(ref), "infix resumed output");
+
+  remove(in.c_str());
+  remove(out.c_str());
+  remove(ref.c_str());
+  remove(ck.c_str());
+  return finishChecks();
+}
@@ -0,0 +1,76 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "RPN.h"
+#include "Stack.h"
+
+// the expressions from input.txt, folded by the compiler
+constexpr double results[] = {
+    evaluateRPN("3 4 + E"),
+    evaluateRPN("3 4 + 5 * E"),
+    evaluateRPN("4 5 7 2 + - *  E"),
+    evaluateRPN("3 4 + 2  * 7 / E"),
+    evaluateRPN("5 7 + 6 2 -  * E"),
+    evaluateRPN("4 2 3 5 1 - + * + E"),
+    evaluateRPN("4 2 + 3 5 1 -  * +  E"),
+    evaluateRPN("5 1 2 + 4 * + 3 - E"),
+    evaluateRPN("17 8 - E"),
+    evaluateRPN("6 2 / 5 + E"),
+    evaluateRPN("5 4 + 7 2 - * E"),
+    evaluateRPN("3 4 + 10 1.5 + * E"),
+    evaluateRPN("3 44 * 5 1.2 + / E"),
+};
+
+static_assert(results[0] == 7.0, "3 4 + must fold to 7");
+static_assert(results[2] == -16.0, "4 5 7 2 + - * must fold to -16");
+static_assert(results[11] == 80.5, "3 4 + 10 1.5 + * must fold to 80.5");
+static_assert(results[12] == 3.0 * 44.0 / (5.0 + 1.2),
+              "compile-time division must match runtime arithmetic");
+static_assert(evaluateRPN("-2.5e1 4 /") == -6.25,
+              "signed and exponent number formats");
+
+int main() {
+  using namespace std;
+
+  const char *expressions[] = {
+      "3 4 + E",
+      "3 4 + 5 * E",
+      "4 5 7 2 + - *  E",
+      "3 4 + 2  * 7 / E",
+      "5 7 + 6 2 -  * E",
+      "4 2 3 5 1 - + * + E",
+      "4 2 + 3 5 1 -  * +  E",
+      "5 1 2 + 4 * + 3 - E",
+      "17 8 - E",
+      "6 2 / 5 + E",
+      "5 4 + 7 2 - * E",
+      "3 4 + 10 1.5 + * E",
+      "3 44 * 5 1.2 + / E",
+  };
+
+  int failures = 0;
+
+  // the runtime calculator must agree bit for bit with the compiler
+  for (unsigned i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+    Stack<double> stack;
+    istringstream in(expressions[i]);
+    string token;
+    double runtime = 0.0;
+
+    while (in >> token) {
+      processToken(stack, token, runtime);
+    }
+
+    cout << expressions[i] << " -> " << results[i] << " (runtime "
+         << runtime << ")" << endl;
+
+    if (runtime != results[i]) {
+      failures++;
+    }
+  }
+
+  cout << failures << " mismatches" << endl;
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include "Fixed.h"
+#include "Session.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+/**
+ * Feed the tokens of some input to a session in an engine, returning
+ * its output.
+ */
+static string evaluate(Engine engine, const string &input) {
+  Session session(engine);
+  istringstream in(input);
+  string token, out;
+  while (in >> token) {
+    session.feed(token, out);
+  }
+  return out;
+}
+
+int main() {
+  const int64_t maxRaw = numeric_limits<int64_t>::max();
+  const int64_t minRaw = numeric_limits<int64_t>::min();
+
+  // conversions and rounding
+  check(Fixed(1.5).bits() == (int64_t(3) << 31), "1.5");
+  check(Fixed(-0.25).bits() == -(int64_t(1) << 30), "-0.25");
+  check(static_cast<double>(Fixed(1234.5)) == 1234.5, "round trip");
+  check(Fixed(1e12).bits() == maxRaw && Fixed(-1e12).bits() == minRaw,
+        "saturating conversion");
+  check(Fixed(numeric_limits<double>::quiet_NaN()).bits() == 0, "NaN");
+  check((Fixed::fromRaw(3) * Fixed(0.5)).bits() == 2, "ties round up");
+  check((Fixed::fromRaw(-3) * Fixed(0.5)).bits() == -1, "negative ties");
+  check((Fixed(1.0) / Fixed(3.0)).bits() == 1431655765, "1 / 3 truncates");
+  check((Fixed(-1.0) / Fixed(3.0)).bits() == -1431655765, "toward zero");
+
+  // saturation
+  Fixed big = Fixed::fromRaw(maxRaw), small = Fixed::fromRaw(minRaw);
+  check((big + Fixed(1.0)).bits() == maxRaw, "add saturates");
+  check((small - Fixed(1.0)).bits() == minRaw, "subtract saturates");
+  check((big * Fixed(-2.0)).bits() == minRaw, "multiply saturates");
+  check((Fixed(1.0) / Fixed()).bits() == maxRaw, "divide by zero");
+  check((Fixed(-1.0) / Fixed()).bits() == minRaw, "negative by zero");
+  check((Fixed() / Fixed()).bits() == 0, "zero by zero");
+
+  // engine names
+  Engine engine = ENGINE_DOUBLE;
+  check(parseEngine("fixed", engine) && engine == ENGINE_FIXED, "fixed");
+  check(parseEngine("long-double", engine) && engine == ENGINE_LONG_DOUBLE,
+        "long-double");
+  check(!parseEngine("int", engine) && engine == ENGINE_LONG_DOUBLE,
+        "unknown engine");
+
+  // the same expression in each engine; 0.1 + 0.2 - 0.3 shows each
+  // type's rounding
+  const char *names[] = {"double", "float", "long-double", "fixed"};
+  const char *expected[] = {">>> 5.55112e-17\n", ">>> 0\n",
+                            ">>> 2.77556e-17\n", ">>> 0\n"};
+  for (int i = 0; i < 4; i++) {
+    string out = evaluate(static_cast<Engine>(i), "0.1 0.2 + 0.3 - E");
+    cout << names[i] << ": " << out;
+    check(out == expected[i], names[i]);
+  }
+
+  // errors and formatting are the same in every engine
+  for (int i = 0; i < 4; i++) {
+    string out = evaluate(static_cast<Engine>(i),
+                          "3 4 + 10 1.5 + * E 1 + E 1 2 E 2 y * E 1 4 / E");
+    check(out == ">>> 80.5\n>>> Error: Too few operands in run()\n"
+                 ">>> Error: Leftover operands in run()\n"
+                 ">>> Error: Bad token y\n>>> 0.25\n",
+          string(names[i]) + " errors");
+  }
+
+  // fixed point saturates where floating point overflows
+  check(evaluate(ENGINE_FIXED, "1 0 / E") == ">>> 2.14748e+09\n",
+        "fixed divide by zero");
+  check(evaluate(ENGINE_DOUBLE, "1 0 / E") == ">>> inf\n",
+        "double divide by zero");
+
+  return finishChecks();
+}
@@ -0,0 +1,96 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Bytecode.h"
+#include "Infix.h"
+#include "Session.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+/**
+ * Check that an infix expression compiles to the same program as a
+ * postfix one.
+ */
+static void checkSame(const string &infix, const string &postfix) {
+  Program a, b;
+  string error;
+  bool ok = compileInfix(infix, a, error);
+
+  istringstream in(postfix);
+  string token;
+  while (in >> token) {
+    compileToken(token, b);
+  }
+
+  bool same = ok && a.size() == b.size();
+  for (size_t i = 0u; same && i < a.size(); i++) {
+    same = a[i].op == b[i].op && a[i].imm == b[i].imm;
+  }
+  cout << infix << "  ->  " << (ok ? postfix : error) << endl;
+  check(same, infix + " is " + postfix);
+}
+
+/**
+ * Check that an infix expression is rejected with an error.
+ */
+static void checkError(const string &infix, const string &expected) {
+  Program program;
+  string error;
+  bool ok = compileInfix(infix, program, error);
+  cout << infix << "  ->  " << error << endl;
+  check(!ok && error == expected, infix + " gives " + expected);
+}
+
+int main() {
+  // precedence, associativity and parentheses
+  checkSame("3 + 4", "3 4 +");
+  checkSame("3 + 4 * 2", "3 4 2 * +");
+  checkSame("(3 + 4) * 2", "3 4 + 2 *");
+  checkSame("8 - 3 - 2", "8 3 - 2 -");
+  checkSame("8 / 4 / 2", "8 4 / 2 /");
+  checkSame("8 - (3 - 2)", "8 3 2 - -");
+  checkSame("2 * 3 - 4 / 5 + 6", "2 3 * 4 5 / - 6 +");
+  checkSame("((1))", "1");
+  checkSame("3+4*(2-1)/$0", "3 4 2 1 - * $0 / +");
+
+  // signs and unary minus
+  checkSame("-3 * +2.5e1", "-3 +2.5e1 *");
+  checkSame("2 - -3", "2 -3 -");
+  checkSame("-(2 + 1)", "2 1 + -1 *");
+  checkSame("-$0 * 2", "$0 -1 * 2 *");
+  checkSame("2 * -(3)", "2 3 -1 * *");
+  checkSame("- - 4", "4 -1 * -1 *");
+  checkSame("+(4)", "4");
+
+  // numbers end where a number must, so "2e" is 2 then e
+  checkSame("1e3-1E-3", "1e3 1E-3 -");
+
+  // syntax errors
+  checkError("", "Missing operand at end");
+  checkError("3 +", "Missing operand at end");
+  checkError("(3 + 4", "Unmatched (");
+  checkError("3 + 4)", "Unmatched ) at column 6");
+  checkError("3 4", "Unexpected 4 at column 3");
+  checkError("3 * / 4", "Missing operand at column 5");
+  checkError("2e", "Unexpected e at column 2");
+  checkError("$x + 1", "Bad operand $ at column 1");
+  checkError("1.2.3", "Bad operand 1.2.3 at column 1");
+  checkError("()", "Missing operand at column 2");
+
+  // a session evaluates each line, and carries on after errors
+  Session session;
+  string out;
+  const char *lines[] = {"(3 + 4) * 2", "", "1 / (2 - 2", "8 - 3 - 2",
+                         "-(0)", "$0 + 1", "10 / 4"};
+  for (const char *line : lines) {
+    session.feedInfix(line, out);
+  }
+  cout << out;
+  check(out == ">>> 14\n>>> Error: Unmatched (\n>>> 3\n>>> -0\n"
+               ">>> Error: Unbound parameter in run()\n>>> 2.5\n",
+        "session replies");
+
+  return finishChecks();
+}
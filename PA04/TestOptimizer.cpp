@@ -0,0 +1,157 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Bytecode.h"
+#include "Optimizer.h"
+#include "Stack.h"
+
+/**
+ * Compile a postfix expression without its "E".
+ */
+Program compile(const std::string &expr) {
+  std::istringstream in(expr);
+  std::string token;
+  Program program;
+
+  while (in >> token) {
+    compileToken(token, program);
+  }
+
+  return program;
+}
+
+/**
+ * Print a program as a list of instructions.
+ */
+std::ostream &operator<<(std::ostream &out, const Program &program) {
+  out << "[";
+  for (std::size_t i = 0u; i < program.size(); i++) {
+    out << opName(program[i].op);
+    if (program[i].op == OP_PUSH || program[i].op == OP_LOAD ||
+        program[i].op == OP_ADD_IMM ||
+        program[i].op == OP_MUL_IMM) {
+      out << " " << program[i].imm;
+    }
+    if (i + 1u < program.size()) {
+      out << ", ";
+    }
+  }
+  out << "]";
+
+  return out;
+}
+
+/**
+ * Optimize an expression, print it before and after, and check that
+ * the result is unchanged with $0 bound to each of a set of awkward
+ * values. Returns the number of failures.
+ */
+int check(const std::string &expr, std::size_t expectedSize) {
+  const double values[] = {1.0, 0.0, -0.0, -3.5, 1e308, INFINITY, NAN};
+  Stack<double> stack;
+  int failures = 0;
+
+  for (double x : values) {
+    Program plain = compile(expr);
+
+    Program optimized = plain;
+    optimize(optimized);
+    Program fused = optimized;
+    fuse(fused);
+
+    double a = run(plain, stack, &x, 1u);
+    double b = run(fused, stack, &x, 1u);
+    if (std::signbit(a) != std::signbit(b) || std::isnan(a) != std::isnan(b) ||
+        (!std::isnan(a) && a != b)) {
+      std::cout << "  MISMATCH for x = " << x << ": " << a << " vs " << b
+                << std::endl;
+      failures++;
+    }
+
+    if (x == 1.0) {
+      std::cout << expr << std::endl
+                << "  " << plain << std::endl
+                << "  " << optimized << std::endl;
+      if (optimized.size() != expectedSize) {
+        std::cout << "  EXPECTED " << expectedSize << " instructions"
+                  << std::endl;
+        failures++;
+      }
+    }
+  }
+
+  return failures;
+}
+
+/**
+ * Check that checkDepth gives the expected status for an expression,
+ * before and after fusing, and agrees with whether run() throws.
+ * Returns the number of failures.
+ */
+int checkStatus(const std::string &expr, RunStatus expected) {
+  Program plain = compile(expr);
+  Program fused = plain;
+  fuse(fused);
+  Stack<double> stack;
+  double x = 2.0;
+  int failures = 0;
+
+  RunStatus status = checkDepth(plain, 1u);
+  bool threw = false;
+  try {
+    run(plain, stack, &x, 1u);
+  } catch (const std::exception &) {
+    threw = true;
+    stack.clear();
+  }
+
+  std::cout << expr << ": " << (status == RUN_OK ? "ok"
+                                : runStatusMessage(status)) << std::endl;
+  if (status != expected || checkDepth(fused, 1u) != expected ||
+      threw != (expected != RUN_OK)) {
+    std::cout << "  EXPECTED " << runStatusMessage(expected) << std::endl;
+    failures++;
+  }
+
+  return failures;
+}
+
+int main() {
+  using namespace std;
+
+  int failures = 0;
+
+  failures += check("17 8 -", 1u);
+  failures += check("6 2 / 5 +", 1u);
+  failures += check("$0 1 *", 1u);
+  failures += check("1 $0 *", 1u);
+  failures += check("$0 1 /", 1u);
+  failures += check("$0 0 -", 1u);
+  failures += check("$0 -0 +", 1u);
+  failures += check("-0 $0 +", 1u);
+  failures += check("$0 0 +", 3u);
+  failures += check("0 $0 +", 3u);
+  failures += check("$0 0 *", 3u);
+  failures += check("$0 4 /", 3u);
+  failures += check("$0 3 /", 3u);
+  failures += check("$0 3 -", 3u);
+  failures += check("$0 2 3 + * 4 2 - 1 * +", 5u);
+  failures += check("1 $0 1 1 + * *", 3u);
+
+  failures += checkStatus("1 2 +", RUN_OK);
+  failures += checkStatus("$0 2 * 3 +", RUN_OK);
+  failures += checkStatus("1 2 3 * + 4 5 + *", RUN_OK);
+  failures += checkStatus("", RUN_UNDERFLOW);
+  failures += checkStatus("+", RUN_UNDERFLOW);
+  failures += checkStatus("1 2 * +", RUN_UNDERFLOW);
+  failures += checkStatus("1 2 3 * + + 4", RUN_UNDERFLOW);
+  failures += checkStatus("1 2", RUN_LEFTOVER);
+  failures += checkStatus("1 2 3 * 4", RUN_LEFTOVER);
+  failures += checkStatus("$1 1 +", RUN_UNBOUND);
+
+  cout << failures << " failures" << endl;
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
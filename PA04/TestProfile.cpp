@@ -0,0 +1,106 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Bytecode.h"
+#include "Profile.h"
+#include "Session.h"
+#include "Stack.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+/**
+ * Count the occurrences of a string in another.
+ */
+static size_t occurrences(const string &text, const string &what) {
+  size_t n = 0u;
+  for (size_t at = text.find(what); at != string::npos;
+       at = text.find(what, at + 1u)) {
+    n++;
+  }
+  return n;
+}
+
+/**
+ * Tests of the profiler; built with -DRPN_PROFILE, so that the
+ * instrumentation in Session and run() records.
+ */
+int main() {
+  Profiler &profiler = Profiler::instance();
+
+  // every operation run is counted under its opcode
+  Program program;
+  const char *tokens[] = {"3", "4", "+", "2", "*", "5", "-"};
+  for (const char *token : tokens) {
+    compileToken(token, program);
+  }
+  Stack<double> stack;
+  run(program, stack);
+  check(profiler.opHistogram(OP_PUSH).count == 4u, "PUSH count");
+  check(profiler.opHistogram(OP_ADD).count == 1u, "ADD count");
+  check(profiler.opHistogram(OP_MUL).count == 1u, "MUL count");
+  check(profiler.opHistogram(OP_SUB).count == 1u, "SUB count");
+  check(profiler.opHistogram(OP_DIV).count == 0u, "DIV count");
+
+  // and each stage of a session, with a read for each of the 12 tokens
+  // and the end of the input; in fixed point nothing is folded, so
+  // "3 4 + 2 *" runs as PUSH, ADD_MUL_IMM
+  profiler.clear();
+  Session session(ENGINE_FIXED);
+  istringstream in("3 4 + 2 * E 1 + E 2 y E");
+  string token, out;
+  while (readToken(in, token)) {
+    session.feed(token, out);
+  }
+  check(out == ">>> 14\n>>> Error: Too few operands in run()\n"
+               ">>> Error: Bad token y\n",
+        "session output");
+  check(profiler.stageHistogram(PROFILE_READ).count == 13u, "read count");
+  check(profiler.stageHistogram(PROFILE_TOKENIZE).count == 9u,
+        "tokenize count");
+  check(profiler.stageHistogram(PROFILE_CHECK).count == 2u, "check count");
+  check(profiler.stageHistogram(PROFILE_EVALUATE).count == 1u,
+        "evaluate count");
+  check(profiler.stageHistogram(PROFILE_FORMAT).count == 1u, "format count");
+  check(profiler.opHistogram(OP_PUSH).count == 1u &&
+            profiler.opHistogram(OP_ADD_MUL_IMM).count == 1u,
+        "fused operations");
+
+  // histogram statistics
+  const ProfileHistogram &h = profiler.stageHistogram(PROFILE_READ);
+  check(h.percentile(50.0) <= h.percentile(99.0), "percentiles ordered");
+  check(h.max <= h.percentile(100.0), "max within top bucket");
+  check(h.total >= h.max, "total");
+
+  // the summary names what was seen, and the trace has one event each
+  ostringstream report, trace;
+  profiler.report(report);
+  profiler.writeTrace(trace);
+  cout << report.str();
+  check(report.str().find("ADD_MUL_IMM") != string::npos, "report ops");
+  check(report.str().find("evaluate") != string::npos, "report stages");
+  check(report.str().find("DIV ") == string::npos, "report skips unseen");
+  string json = trace.str();
+  check(json.compare(0, 16, "{\"traceEvents\":[") == 0, "trace header");
+  check(json.find("\n],\"displayTimeUnit\":\"ns\"}") != string::npos,
+        "trace footer");
+  check(occurrences(json, "\"ph\":\"X\"") == 13u + 9u + 2u + 1u + 1u + 2u,
+        "one trace event per stage and operation");
+  check(occurrences(json, "\"cat\":\"op\"") == 2u, "operation events");
+
+  // events over the limit are dropped from the trace but still counted
+  Profiler small(2u);
+  for (int i = 0; i < 5; i++) {
+    small.recordStage(PROFILE_WRITE, 100u, 150u);
+  }
+  ostringstream smallTrace;
+  small.writeTrace(smallTrace);
+  check(small.stageHistogram(PROFILE_WRITE).count == 5u &&
+            small.stageHistogram(PROFILE_WRITE).total == 250u,
+        "histogram past the limit");
+  check(small.droppedEvents() == 3u, "dropped events");
+  check(occurrences(smallTrace.str(), "\"ph\"") == 2u, "kept events");
+
+  return finishChecks();
+}
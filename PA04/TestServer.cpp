@@ -0,0 +1,145 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Server.h"
+#include "TestCheck.h"
+
+using namespace std;
+
+/**
+ * Connect to the server, waiting for it to start.
+ */
+static int connectTo(const string &path) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1u);
+
+  for (int attempt = 0; attempt < 100; attempt++) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+      return fd;
+    }
+    close(fd);
+    usleep(20000);
+  }
+
+  return -1;
+}
+
+/**
+ * Send text over a connection.
+ */
+static void sendText(int fd, const string &text) {
+  if (send(fd, text.data(), text.size(), MSG_NOSIGNAL) !=
+      static_cast<ssize_t>(text.size())) {
+    check(false, "send");
+  }
+}
+
+/**
+ * Read lines from a connection until count have arrived, or the end.
+ */
+static string readLines(int fd, int count) {
+  string text;
+  char c;
+  while (count > 0 && read(fd, &c, 1) == 1) {
+    text += c;
+    count -= c == '\n';
+  }
+  return text;
+}
+
+int main() {
+  string path = "/tmp/TestServer." + to_string(getpid()) + ".sock";
+
+  // a file that isn't a socket is never removed to make way for one
+  { ofstream(path.c_str()) << "keep\n"; }
+  check(serve(path) == EXIT_FAILURE, "refuses a regular file");
+  check(access(path.c_str(), F_OK) == 0, "regular file kept");
+  unlink(path.c_str());
+
+  pid_t child = fork();
+  if (child == 0) {
+    _exit(serve(path));
+  }
+
+  // the expressions from input.txt, sent in small pieces that split
+  // tokens, must give the same replies as the interactive calculator
+  ifstream inFile("input.txt"), outFile("output.txt");
+  stringstream input, output;
+  input << inFile.rdbuf();
+  string line, expected;
+  int lines = 0;
+  while (getline(outFile, line)) {
+    if (!line.empty() && line[line.size() - 1u] == '\r') {
+      line.erase(line.size() - 1u);
+    }
+    if (line.compare(0, 4, ">>> ") == 0) {
+      expected += line + "\n";
+      lines++;
+    }
+  }
+
+  int fd = connectTo(path);
+  check(fd >= 0, "connect");
+  string text = input.str();
+  for (size_t i = 0u; i < text.size(); i += 7u) {
+    sendText(fd, text.substr(i, 7u));
+  }
+  shutdown(fd, SHUT_WR);
+  string replies = readLines(fd, lines + 1);
+  close(fd);
+  check(replies == expected, "replies match output.txt");
+  cout << replies;
+
+  // each connection has its own state; a half-sent expression on one,
+  // ending in half a token, doesn't affect another
+  int a = connectTo(path), b = connectTo(path);
+  sendText(a, "3 4");
+  sendText(b, "1 2 + E 2 x * E 1 1 E\n");
+  string bReplies = readLines(b, 3);
+  sendText(a, "0 + E ");
+  string aReply = readLines(a, 1);
+  cout << bReplies << aReply;
+  check(bReplies == ">>> 3\n>>> Error: Bad token x\n"
+                    ">>> Error: Leftover operands in run()\n",
+        "second connection");
+  check(aReply == ">>> 43\n", "first connection");
+
+  // and keeps working after an error
+  sendText(b, "6 7 * E\n");
+  check(readLines(b, 1) == ">>> 42\n", "state after an error");
+
+  // a token with no end is rejected once it is too long, and the rest
+  // of it and of its expression is dropped
+  sendText(b, "1 ");
+  for (int i = 0; i < 64; i++) {
+    sendText(b, string(1024u, '9'));
+  }
+  sendText(b, " 2 + E 6 7 * E\n");
+  string longReplies = readLines(b, 2);
+  cout << longReplies;
+  check(longReplies == ">>> Error: Bad token 9999999999999999...\n"
+                       ">>> 42\n",
+        "over-long token");
+  close(a);
+  close(b);
+
+  // SIGTERM stops the server cleanly
+  kill(child, SIGTERM);
+  int status = 0;
+  waitpid(child, &status, 0);
+  check(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS,
+        "clean exit");
+  check(access(path.c_str(), F_OK) != 0, "socket removed");
+
+  return finishChecks();
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "RPN.h"
+
+//-----------------------------------------------------------
+// class definitions
+//-----------------------------------------------------------
+
+/**
+ * Shape of a generated calculator workload; see generateWorkload().
+ */
+struct WorkloadOptions {
+  /**
+   * Constructor. Make the defaults: mixed expressions of 2 to 8 operands
+   * in every number format, none malformed.
+   */
+  WorkloadOptions()
+      : expressions(100000), seed(46u), minOperands(2u), maxOperands(8u),
+        maxDepth(4u), operators("+-*/"), formats("idse"),
+        malformedPercent(0u) {}
+
+  /** Number of expressions, one per line. */
+  long expressions;
+
+  /** Seed of the random number generator; equal seeds, equal output. */
+  unsigned seed;
+
+  /** Fewest operands in an expression. */
+  unsigned minOperands;
+
+  /** Most operands in an expression. */
+  unsigned maxOperands;
+
+  /** Most values on the stack at once, at least 2. */
+  unsigned maxDepth;
+
+  /**
+   * Operators to choose from, uniformly by position, so "++*" makes two
+   * thirds of them additions.
+   */
+  std::string operators;
+
+  /**
+   * Number formats to choose from, in the same way: 'i' integers, e.g.,
+   * 42; 'd' decimals, e.g., 3.25; 's' signed, e.g., -7 or +0.5; 'e'
+   * exponents, e.g., 1.5e3 or 25e-2.
+   */
+  std::string formats;
+
+  /**
+   * Percentage of expressions made malformed, in equal shares: an extra
+   * operator, an extra operand, or a bad token.
+   */
+  unsigned malformedPercent;
+};
+
+//-----------------------------------------------------------
+// function implementations
+//-----------------------------------------------------------
+
+/**
+ * Set one workload option from a "name=value" argument: expressions=N,
+ * seed=N, operands=MIN-MAX, depth=N, operators=CHARS, formats=CHARS or
+ * malformed=PERCENT.
+ *
+ * \param arg Argument to parse.
+ *
+ * \param options Options to update.
+ *
+ * \return true if the argument is a valid option.
+ */
+inline bool parseWorkloadOption(const std::string &arg,
+                                WorkloadOptions &options) {
+  std::size_t eq = arg.find('=');
+  if (eq == std::string::npos || eq + 1u == arg.size()) {
+    return false;
+  }
+  std::string name = arg.substr(0u, eq), value = arg.substr(eq + 1u);
+  const char *text = value.c_str();
+  unsigned a = 0u, b = 0u;
+  char extra;
+
+  if (name == "expressions") {
+    return std::sscanf(text, "%ld%c", &options.expressions, &extra) == 1 &&
+           options.expressions >= 0;
+  } else if (name == "seed") {
+    return std::sscanf(text, "%u%c", &options.seed, &extra) == 1;
+  } else if (name == "operands") {
+    int n = std::sscanf(text, "%u-%u%c", &a, &b, &extra);
+    if (n == 1) {
+      b = a;
+    }
+    options.minOperands = a;
+    options.maxOperands = b;
+    return (n == 1 || n == 2) && a >= 1u && a <= b;
+  } else if (name == "depth") {
+    return std::sscanf(text, "%u%c", &options.maxDepth, &extra) == 1 &&
+           options.maxDepth >= 2u;
+  } else if (name == "operators") {
+    options.operators = value;
+    return value.find_first_not_of("+-*/") == std::string::npos;
+  } else if (name == "formats") {
+    options.formats = value;
+    return value.find_first_not_of("idse") == std::string::npos;
+  } else if (name == "malformed") {
+    return std::sscanf(text, "%u%c", &options.malformedPercent, &extra) ==
+               1 &&
+           options.malformedPercent <= 100u;
+  }
+  return false;
+}
+
+/**
+ * Make a random number token in one of the formats of
+ * WorkloadOptions::formats. Values are never zero.
+ *
+ * \param format Format letter.
+ *
+ * \param gen Random number generator.
+ *
+ * \return Number token.
+ */
+inline std::string randomNumber(char format, std::mt19937 &gen) {
+  char text[32];
+  unsigned whole = 1u + gen() % 999u;
+  unsigned fraction = 1u + gen() % 999u;
+
+  switch (format) {
+  case 'd':
+    std::snprintf(text, sizeof(text), "%u.%03u", whole % 100u, fraction);
+    break;
+  case 's':
+    if (gen() % 2u) {
+      std::snprintf(text, sizeof(text), "-%u", whole);
+    } else {
+      std::snprintf(text, sizeof(text), "+%u.%u", whole, fraction);
+    }
+    break;
+  case 'e':
+    std::snprintf(text, sizeof(text), "%u.%ue%d", whole % 10u, fraction,
+                  static_cast<int>(gen() % 13u) - 6);
+    break;
+  default:
+    std::snprintf(text, sizeof(text), "%u", whole);
+  }
+
+  return text;
+}
+
+/**
+ * Generate a calculator workload: postfix expressions, one per line and
+ * each ending in "E", and optionally the replies the calculator should
+ * give. The same options always give the same workload, on any machine.
+ *
+ * Each expression has between minOperands and maxOperands operands and
+ * never more than maxDepth values on the stack; operators are applied
+ * at random as soon as there are two values, and always once the stack
+ * is full. Expected values are computed in double in postfix order,
+ * which the calculator's folding and fusing preserve.
+ *
+ * \param options Shape of the workload, as checked by
+ * parseWorkloadOption().
+ *
+ * \param postfix Stream to write the expressions to.
+ *
+ * \param expected Stream to write the expected reply lines to, ">>> "
+ * and a value or error, or 0 not to.
+ *
+ * \return Number of tokens written, including the "E"s.
+ */
+inline long generateWorkload(const WorkloadOptions &options,
+                             std::ostream &postfix, std::ostream *expected) {
+  std::mt19937 gen(options.seed);
+  std::vector<std::string> tokens;
+  std::vector<double> stack;
+  unsigned span = options.maxOperands - options.minOperands + 1u;
+  long count = 0;
+
+  for (long e = 0; e < options.expressions; e++) {
+    tokens.clear();
+    stack.clear();
+
+    unsigned left = options.minOperands + gen() % span;
+    while (left > 0u || stack.size() > 1u) {
+      std::size_t depth = stack.size();
+      bool push = left > 0u && (depth < 2u ||
+                                (depth < options.maxDepth && gen() % 2u));
+      if (push) {
+        tokens.push_back(randomNumber(
+            options.formats[gen() % options.formats.size()], gen));
+        double value = 0.0;
+        parseNumber(tokens.back(), value);
+        stack.push_back(value);
+        left--;
+      } else {
+        char op = options.operators[gen() % options.operators.size()];
+        tokens.push_back(std::string(1u, op));
+        double rhs = stack.back();
+        stack.pop_back();
+        stack.back() = applyOperator(op, stack.back(), rhs);
+      }
+    }
+
+    // spoil some expressions
+    std::string reply;
+    if (gen() % 100u < options.malformedPercent) {
+      switch (gen() % 3u) {
+      case 0u:
+        tokens.push_back("+");
+        reply = "Error: Too few operands in run()";
+        break;
+      case 1u:
+        tokens.insert(tokens.begin(), "1");
+        reply = "Error: Leftover operands in run()";
+        break;
+      default:
+        tokens[gen() % tokens.size()] = "x";
+        reply = "Error: Bad token x";
+      }
+    } else {
+      char text[32];
+      std::snprintf(text, sizeof(text), "%g", stack.back());
+      reply = text;
+    }
+
+    for (std::size_t i = 0u; i < tokens.size(); i++) {
+      postfix << tokens[i] << ' ';
+    }
+    postfix << "E\n";
+    count += static_cast<long>(tokens.size()) + 1;
+
+    if (expected) {
+      *expected << ">>> " << reply << '\n';
+    }
+  }
+
+  return count;
+}
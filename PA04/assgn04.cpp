@@ -1,32 +1,207 @@
-#include <cstdlib>
-#include <iostream>
-#include <set>
-#include <string>
-#include "Stack.h"
-
-/**
- * Main program for the Doane RPN calculator.
- */
-int main() {
-    using namespace std;
-    
-    // welcome prompt
-    cout << "Welcome to the Doane RPN Calculator!" << endl;
-    cout << "Please enter an expression in postfix, EOF to quit." << endl;
-    
-    // prepare stack
-    Stack<double> stack;
-
-    // read string tokens until there is nothing more to read    
-    string token;
-    while(cin >> token) {
-        // TODO: based on token type (operator, "E", or number),
-        // use the stack to implement the operations of the
-        // RPN calculator. 
-    }
-    
-    // good by prompt
-    cout << "Good bye!" << endl;
-    
-    return EXIT_SUCCESS;
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Batch.h"
+#include "Checkpoint.h"
+#include "Server.h"
+#include "Session.h"
+
+/**
+ * Main program for the Doane RPN calculator. With "--serve path" it
+ * runs as a server on a Unix domain socket instead of reading standard
+ * input; see serve(). With "--engine name" it evaluates in float,
+ * long-double or fixed point instead of double. With "--infix" it reads
+ * one infix expression per line, e.g., "(3 + 4) * 2", instead of
+ * postfix; see compileInfix(). With "--batch" it evaluates postfix
+ * expressions in batches, computing each subexpression shared between
+ * them once, and reports the evaluations saved on standard error; see
+ * ExpressionBatch.
+ *
+ * With "--input file" and "--output file" it reads and writes files
+ * instead of standard input and output. Then "--checkpoint file" saves
+ * its progress every 10000 expressions, or every n with
+ * "--checkpoint-every n", and "--resume" continues a run that died from
+ * its last checkpoint: the input is read, and the output written, from
+ * the saved offsets, so nothing before them is read or evaluated again.
+ */
+int main(int argc, char *argv[]) {
+    using namespace std;
+
+    // parse the options
+    Engine engine = ENGINE_DOUBLE;
+    const char *socketPath = 0, *inputPath = 0, *outputPath = 0;
+    const char *checkpointPath = 0;
+    long checkpointEvery = 10000;
+    bool infix = false, batch = false, resume = false, usageError = false;
+    for (int i = 1; i < argc; i += 2) {
+        string option = argv[i];
+        if (option == "--infix") {
+            infix = true;
+            i--;
+        } else if (option == "--batch") {
+            batch = true;
+            i--;
+        } else if (option == "--resume") {
+            resume = true;
+            i--;
+        } else if (i + 1 >= argc) {
+            usageError = true;
+        } else if (option == "--serve") {
+            socketPath = argv[i + 1];
+        } else if (option == "--input") {
+            inputPath = argv[i + 1];
+        } else if (option == "--output") {
+            outputPath = argv[i + 1];
+        } else if (option == "--checkpoint") {
+            checkpointPath = argv[i + 1];
+        } else if (option == "--checkpoint-every") {
+            checkpointEvery = atol(argv[i + 1]);
+            usageError = usageError || checkpointEvery <= 0;
+        } else if (option != "--engine" || !parseEngine(argv[i + 1], engine)) {
+            usageError = true;
+        }
+    }
+    if (usageError || infix + batch + (socketPath != 0) > 1 ||
+        (batch && engine != ENGINE_DOUBLE) ||
+        (socketPath && (inputPath || outputPath)) ||
+        (checkpointPath && (!inputPath || !outputPath || batch)) ||
+        (resume && !checkpointPath)) {
+        cerr << "Usage: " << argv[0]
+             << " [--serve socket-path | --infix | --batch]"
+             << " [--engine double|float|long-double|fixed]"
+             << " [--input file] [--output file]"
+             << " [--checkpoint file [--checkpoint-every n] [--resume]]"
+             << endl;
+        return EXIT_FAILURE;
+    }
+    if (socketPath) {
+        return serve(socketPath, engine);
+    }
+    
+    // when resuming, seek the input to the checkpoint, and cut the
+    // output back to it, losing any replies written after it
+    Checkpoint checkpoint;
+    if (resume) {
+        struct stat in, out;
+        if (!readCheckpoint(checkpointPath, checkpoint)) {
+            cerr << "Cannot read checkpoint " << checkpointPath << endl;
+            return EXIT_FAILURE;
+        }
+        if (stat(inputPath, &in) != 0 || stat(outputPath, &out) != 0 ||
+            static_cast<uint64_t>(in.st_size) < checkpoint.inputOffset ||
+            static_cast<uint64_t>(out.st_size) < checkpoint.outputOffset ||
+            truncate(outputPath, checkpoint.outputOffset) != 0) {
+            cerr << "Checkpoint " << checkpointPath << " doesn't match "
+                 << inputPath << " and " << outputPath << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the streams, standard ones unless files are given
+    ifstream inputFile;
+    ofstream outputFile;
+    if (inputPath) {
+        inputFile.open(inputPath);
+        inputFile.seekg(checkpoint.inputOffset);
+    }
+    if (outputPath) {
+        outputFile.open(outputPath, resume ? ios::in : ios::trunc);
+        outputFile.seekp(checkpoint.outputOffset);
+    }
+    if ((inputPath && !inputFile) || (outputPath && !outputFile)) {
+        cerr << "Cannot open " << (inputFile ? outputPath : inputPath)
+             << endl;
+        return EXIT_FAILURE;
+    }
+    istream &input = inputPath ? static_cast<istream &>(inputFile) : cin;
+    ostream &output = outputPath ? static_cast<ostream &>(outputFile) : cout;
+
+    // welcome prompt, which a resumed run has already written
+    if (!resume) {
+        output << "Welcome to the Doane RPN Calculator!" << endl;
+        output << "Please enter an expression in "
+               << (infix ? "infix" : "postfix") << ", EOF to quit." << endl;
+    }
+    
+    // the calculator state, and its output for the last token
+    Session session(engine);
+    string out;
+
+    // a terminal or pipe is flushed after every reply, for whoever is
+    // waiting on it, and an output file only at checkpoints
+    bool interactive = !outputPath;
+    bool checkpointed = true;
+
+    // in infix, read lines until there is nothing more to read
+    string line;
+    while (infix && checkpointed && readLine(input, line)) {
+        session.feedInfix(line, out);
+        if (!out.empty()) {
+            RPN_PROFILE_STAGE(PROFILE_WRITE);
+            output << out;
+            if (interactive) {
+                output.flush();
+            }
+            out.clear();
+        }
+        if (checkpointPath) {
+            checkpointed = advanceCheckpoint(checkpointPath, checkpointEvery,
+                                             input, output, checkpoint);
+        }
+    }
+
+    // in batch mode, output a batch's replies once it is full and at
+    // the end, so that memory stays bounded on large inputs
+    const size_t batchSize = 65536;
+    BatchSession batchSession;
+    string token;
+    while (batch && readToken(input, token)) {
+        batchSession.feed(token);
+        if (batchSession.waiting() == batchSize) {
+            batchSession.flush(out);
+            output << out;
+            out.clear();
+        }
+    }
+    if (batch) {
+        batchSession.flush(out);
+        output << out;
+        out.clear();
+        const ExpressionBatch &stats = batchSession.statistics();
+        unsigned long long saved =
+            stats.operationCount() - stats.evaluatedCount();
+        cerr << "Batch: " << stats.operationCount() << " operations, "
+             << stats.evaluatedCount() << " evaluated, " << saved
+             << " saved" << endl;
+    }
+
+    // in postfix, read string tokens until there is nothing more to read    
+    while(!infix && !batch && checkpointed && readToken(input, token)) {
+        session.feed(token, out);
+        if (!out.empty()) {
+            RPN_PROFILE_STAGE(PROFILE_WRITE);
+            output << out;
+            if (interactive) {
+                output.flush();
+            }
+            out.clear();
+        }
+        if (checkpointPath && token == "E") {
+            checkpointed = advanceCheckpoint(checkpointPath, checkpointEvery,
+                                             input, output, checkpoint);
+        }
+    }
+    if (!checkpointed) {
+        cerr << "Cannot write checkpoint " << checkpointPath << endl;
+        return EXIT_FAILURE;
+    }
+    
+    // good by prompt
+    output << "Good bye!" << endl;
+    RPN_PROFILE_REPORT();
+    
+    return EXIT_SUCCESS;
 }
\ No newline at end of file